@@ -4,372 +4,8 @@
 #include <time.h>
 #include "graph.h"
 #include "performanceMeasure.h"
-#include <stdbool.h>
-
-typedef struct {
-    int* vertices;
-    int size;
-} Clique;
-
-
-bool isNeighbor(Graph* graph, int u, int v) {
-    Node* neighbor = graph->array[u].head;
-    while (neighbor) {
-        if (neighbor->dest == v) return true;
-        neighbor = neighbor->next;
-    }
-    return false;
-}
-void findTriangles(Graph* graph, int* labels, int* clique_count, Clique*** cliques, int* cliques_size) {
-    printf("Running find triangles...\n");
-    int V = graph->V;
-
-    for (int u = 0; u < V; u++) {
-        Node* neighbor = graph->array[u].head;
-        while (neighbor) {
-            int v = neighbor->dest;
-            if (v > u) { // Avoid duplicate triangle counting
-                Node* neighbor2 = graph->array[v].head;
-                while (neighbor2) {
-                    int w = neighbor2->dest;
-                    if (w > v && isNeighbor(graph, u, w)) {
-                        printf("Triangle found: %d, %d, %d\n", u, v, w);
-
-                        // Check if we need to resize the cliques array
-                        if (*clique_count >= *cliques_size) {
-                            *cliques_size *= 2;
-                            *cliques = (Clique**)realloc(*cliques, (*cliques_size) * sizeof(Clique*));
-                            if (!*cliques) {
-                                printf("Memory allocation failed for cliques array\n");
-                                exit(1);
-                            }
-                        }
-
-                        // Allocate memory for the new clique
-                        (*cliques)[*clique_count] = (Clique*)malloc(sizeof(Clique));
-                        if (!(*cliques)[*clique_count]) {
-                            printf("Memory allocation failed for cliques[%d]\n", *clique_count);
-                            exit(1);
-                        }
-                        (*cliques)[*clique_count]->vertices = (int*)malloc(3 * sizeof(int));
-                        if (!(*cliques)[*clique_count]->vertices) {
-                            printf("Memory allocation failed for cliques[%d]->vertices\n", *clique_count);
-                            exit(1);
-                        }
-
-                        // Assign vertices to the clique
-                        (*cliques)[*clique_count]->vertices[0] = u;
-                        (*cliques)[*clique_count]->vertices[1] = v;
-                        (*cliques)[*clique_count]->vertices[2] = w;
-                        (*cliques)[*clique_count]->size = 3;
-
-                        // Increment the clique count
-                        (*clique_count)++;
-                    }
-                    neighbor2 = neighbor2->next;
-                }
-            }
-            neighbor = neighbor->next;
-        }
-    }
-}
-
-void BronKerboschPivot(Graph* graph, int* R, int* P, int* X, int k, Clique*** cliques, int* clique_count, int* cliques_size) {
-    if (k == 0) {
-        // Found a clique
-        if (*clique_count >= *cliques_size) {
-            *cliques_size *= 2;
-            *cliques = (Clique**)realloc(*cliques, (*cliques_size) * sizeof(Clique*));
-            if (!*cliques) {
-                printf("Memory allocation failed for cliques array\n");
-                exit(1);
-            }
-        }
-
-        (*cliques)[*clique_count] = (Clique*)malloc(sizeof(Clique));
-        if (!(*cliques)[*clique_count]) {
-            printf("Memory allocation failed for cliques[%d]\n", *clique_count);
-            exit(1);
-        }
-        (*cliques)[*clique_count]->vertices = (int*)malloc(k * sizeof(int));
-        if (!(*cliques)[*clique_count]->vertices) {
-            printf("Memory allocation failed for cliques[%d]->vertices\n", *clique_count);
-            exit(1);
-        }
-
-        for (int i = 0; i < k; i++) {
-            (*cliques)[*clique_count]->vertices[i] = R[i];
-        }
-        (*cliques)[*clique_count]->size = k;
-        (*clique_count)++;
-        return;
-    }
-
-    // Choose pivot
-    int pivot = -1;
-    int max_degree = -1;
-    for (int i = 0; i < graph->V; i++) {
-        if (P[i]) {
-            // Calculate the degree of node i by traversing its adjacency list
-            int degree = 0;
-            Node* node = graph->array[i].head;
-            while (node) {
-                degree++;
-                node = node->next;
-            }
-
-            // If this node has a higher degree, select it as the pivot
-            if (degree > max_degree) {
-                max_degree = degree;
-                pivot = i;
-            }
-        }
-    }
-
-    int* newP = (int*)malloc(graph->V * sizeof(int));
-    int* newX = (int*)malloc(graph->V * sizeof(int));
-
-    for (int u = 0; u < graph->V; u++) {
-        if (P[u] && !isNeighbor(graph, u, pivot)) {
-            // Add to R
-            R[k] = u;
-
-            // Recalculate newP and newX
-            int newP_size = 0;
-            int newX_size = 0;
-            for (int i = 0; i < graph->V; i++) {
-                if (P[i] && isNeighbor(graph, u, i)) {
-                    newP[newP_size++] = i;
-                }
-                if (X[i] && isNeighbor(graph, u, i)) {
-                    newX[newX_size++] = i;
-                }
-            }
-
-            // Recurse
-            BronKerboschPivot(graph, R, newP, newX, k + 1, cliques, clique_count, cliques_size);
-
-            // Remove u from P and add to X
-            P[u] = 0;
-            X[u] = 1;
-        }
-    }
-
-    free(newP);
-    free(newX);
-}
-
-
-void findCliques(Graph* graph, int k, int* labels, Clique*** cliques, int* clique_count, int* cliques_size) {
-    printf("Finding cliques of size %d...\n", k);
-
-    // if (k == 3) {
-    //     findTriangles(graph, labels, clique_count, cliques, cliques_size);
-    // } else {
-        int* R = (int*)malloc(graph->V * sizeof(int));
-        int* P = (int*)malloc(graph->V * sizeof(int));
-        int* X = (int*)malloc(graph->V * sizeof(int));
-
-        for (int i = 0; i < graph->V; i++) {
-            P[i] = 1;
-            X[i] = 0;
-        }
-
-        BronKerboschPivot(graph, R, P, X, 0, cliques, clique_count, cliques_size);
-
-        free(R);
-        free(P);
-        free(X);
-
-    printf("Cliques found: %d\n", *clique_count);
-    for (int i = 0; i < *clique_count; ++i) {
-        if ((*cliques)[i] != NULL) {
-            // //printf("Clique %d: ", i);
-            // for (int j = 0; j < (*cliques)[i]->size; ++j) {
-            //     printf("%d ", (*cliques)[i]->vertices[j]);
-            // }
-            // printf("\n");
-        } else {
-            printf("Clique %d is NULL\n", i);
-        }
-    }
-}
-
-void addCliqueEdge(Graph* clique_graph, int i, int j) {
-    addEdge(clique_graph, i, j);
-}
-bool hasValidClique(Clique* clique, int k) {
-    return clique != NULL && clique->vertices != NULL && clique->size == k;
-}
-
-Graph* buildCliqueGraph(Clique** cliques, int clique_count, int k, int directed) {
-    printf("Building clique graph...\n");
-
-    // Step 1: Create the clique graph
-    Graph* clique_graph = createGraph(clique_count, directed);
-
-    // Step 2: Loop through cliques and check each for valid pointer and vertices
-    for (int i = 0; i < clique_count; ++i) {
-        if (!hasValidClique(cliques[i], k)) {
-            continue;  // Skip invalid clique
-        }
-
-        for (int j = i + 1; j < clique_count; ++j) {
-            if (!hasValidClique(cliques[j], k)) {
-                continue;  // Skip invalid clique
-            }
-
-            int shared_vertices = 0;
-
-            // Step 3: Use hash sets for fast lookup to find shared vertices
-            for (int vi = 0; vi < k; ++vi) {
-                for (int vj = 0; vj < k; ++vj) {
-                    if (cliques[i]->vertices[vi] == cliques[j]->vertices[vj]) {
-                        shared_vertices++;
-                    }
-                }
-            }
-
-            // Step 4: Add edge if necessary (based on shared vertices)
-            if (shared_vertices >= k - 1) {
-                addCliqueEdge(clique_graph, i, j);
-            }
-        }
-    }
-
-    printf("Clique graph built\n");
-    return clique_graph;
-}
-
-void DFSUtil(Graph* graph, int v, int* visited, int* component, int component_id) {
-    visited[v] = 1;
-    component[v] = component_id;
-    Node* node = graph->array[v].head;
-    while (node) {
-        if (!visited[node->dest]) {
-            DFSUtil(graph, node->dest, visited, component, component_id);
-        }
-        node = node->next;
-    }
-}
-
-void decomposeGraph(Graph* graph, int* component, int* component_count) {
-    printf("Decomposing graph into connected components...\n");
-    int V = graph->V;
-    int* visited = (int*)calloc(V, sizeof(int));
-    *component_count = 0;
-
-    for (int v = 0; v < V; ++v) {
-        if (!visited[v]) {
-            DFSUtil(graph, v, visited, component, *component_count);
-            (*component_count)++;
-        }
-    }
-    printf("Graph decomposed.\n");
-    free(visited);
-}
-
-void mapCliquesToNodes(int* labels, int V, Clique** cliques, int num_cliques, int* component_labels) {
-    printf("Mapping cliques to original graph...\n");
-
-    // Map each node in the cliques to its component
-    for (int i = 0; i < num_cliques; ++i) {
-        int component = component_labels[i];  // The component of the current clique
-        Clique* clique = cliques[i];
-        for (int j = 0; j < clique->size; ++j) {
-            labels[clique->vertices[j]] = component;
-        }
-    }
-
-    printf("Cliques mapped.\n");
-}
-
-void cliqueCommunity(Graph* graph, int k, int* labels, int directed) {
-    printf("Running clique community detection...\n");
-    int cliques_size = graph->V;
-    Clique** cliques = (Clique**)malloc(cliques_size * sizeof(Clique*));
-    int clique_count = 0;
-    findCliques(graph, k, labels, &cliques, &clique_count, &cliques_size);
-
-    Graph* clique_graph = buildCliqueGraph(cliques, clique_count, k, directed);
-
-    int* component = (int*)malloc(clique_count * sizeof(int));
-    int component_count = 0;
-    decomposeGraph(clique_graph, component, &component_count);
-
-    // Print the component array to verify component labels
-    // printf("Component labels:\n");
-    // for (int i = 0; i < clique_count; ++i) {
-    //     printf("Clique %d -> Component %d\n", i, component[i]);
-    // }
-
-   // Call the mapCliquesToNodes function
-    mapCliquesToNodes(labels, graph->V, cliques, clique_count, component);
-
-    // Free allocated memory
-    for (int i = 0; i < clique_count; ++i) {
-        free(cliques[i]->vertices);
-        free(cliques[i]);
-    }
-    free(cliques);
-    free(component);
-    freeGraph(clique_graph);
-    printf("Clique community detection completed.\n");
-}
-
-void printCommunities(int* labels, int V) {
-    printf("Printing communities...\n");
-
-    // Step 1: Determine the maximum label value
-    int max_label = -1;
-    for (int i = 0; i < V; ++i) {
-        if (labels[i] >= 0 && labels[i] > max_label) {
-            max_label = labels[i];
-        }
-    }
-
-    if (max_label == -1) {
-        printf("No communities found.\n");
-        return;
-    }
-
-    // Step 2: Allocate memory for community counts
-    int* community_count = (int*)calloc(max_label + 1, sizeof(int));
-    if (!community_count) {
-        fprintf(stderr, "Memory allocation failed for community_count\n");
-        return;
-    }
-
-    // Step 3: Count nodes in each community
-    for (int i = 0; i < V; ++i) {
-        if (labels[i] >= 0) {
-            community_count[labels[i]]++;
-        }
-    }
-
-    // Step 4: Count number of communities and print results
-    int num_communities = 0;
-    for (int i = 0; i <= max_label; ++i) {
-        if (community_count[i] > 0) {
-            num_communities++;
-        }
-    }
-
-    printf("\nNumber of Communities: %d\n", num_communities);
-
-    int counter = 1;
-    for (int i = 0; i <= max_label; ++i) {
-        if (community_count[i] > 0) {
-            printf("Community %d: %d nodes\n", counter++, community_count[i]);
-        }
-    }
-
-    printf("\n");
-
-    // Step 5: Free allocated memory
-    free(community_count);
-    printf("Communities printed.\n");
-}
+#include "communityLib.h"
+#include "cliquePercolation.h"
 
 int main() {
     int directed = 0;
@@ -391,11 +27,59 @@ int main() {
     }
     printf("Graph successfully created with %d vertices.\n", V);
 
+    // Compressed mode: store the adjacency as sorted varint gaps (read-only, so it cannot
+    // be combined with the dynamic update mode below)
+    int compressed = 0;
+    if (compressed) {
+        compressGraph(graph);
+    }
+
     int k = 3; // Size of cliques
 
+    // Sweep mode: enumerate cliques once and report CPM communities for every k in [k_min, k_max]
+    int sweep = 0;
+    int k_min = 3;
+    int k_max = 10;
+
     // Measure the execution time of the CPM algorithm
     clock_t start, end;
     double cpu_time_used;
+
+    if (sweep) {
+        int levels = k_max - k_min + 1;
+        int** labels_per_k = (int**)malloc(levels * sizeof(int*));
+        if (!labels_per_k) {
+            fprintf(stderr, "Memory allocation failed for labels\n");
+            exit(1);
+        }
+        for (int l = 0; l < levels; ++l) {
+            labels_per_k[l] = (int*)malloc(V * sizeof(int));
+            if (!labels_per_k[l]) {
+                fprintf(stderr, "Memory allocation failed for labels\n");
+                exit(1);
+            }
+        }
+
+        start = clock();
+        cliqueCommunitySweep(graph, k_min, k_max, labels_per_k);
+        end = clock();
+        cpu_time_used = ((double)(end - start)) / CLOCKS_PER_SEC;
+
+        for (int l = 0; l < levels; ++l) {
+            printf("\n===== k = %d =====\n", k_min + l);
+            printCommunities(labels_per_k[l], V);
+            printf("Modularity: %f\n", calculateModularity(graph, labels_per_k[l], V, graph->E, directed));
+            printf("Conductance: %f\n", calculateConductance(graph, labels_per_k[l], V, directed));
+            printf("Coverage: %f\n", calculateCoverage(graph, labels_per_k[l], V, graph->E, directed));
+            free(labels_per_k[l]);
+        }
+        free(labels_per_k);
+
+        printf("Execution Time: %f seconds\n", cpu_time_used);
+        freeGraph(graph);
+        return 0;
+    }
+
     start = clock();
 
     // Run the CPM algorithm
@@ -413,7 +97,17 @@ int main() {
 
     printf("Labels initialized to -1.\n");
     
-    cliqueCommunity(graph, k, labels, directed);
+    // Checkpointed mode: percolate through a CPM state saved every checkpoint_interval root
+    // vertices, so a preempted run resumes from the last checkpoint instead of from scratch
+    const char* checkpoint_filename = NULL; // e.g. "C:datasets\\outego-facebook.cpmckpt"
+    int checkpoint_interval = 1000;
+    if (checkpoint_filename) {
+        CpmState* state = createCpmStateCheckpointed(graph, k, checkpoint_filename, checkpoint_interval);
+        cpmStateLabels(state, graph, labels);
+        freeCpmState(state);
+    } else {
+        cliqueCommunity(graph, k, labels, directed);
+    }
     printf("CPM completed.\n");
 
     end = clock();
@@ -435,6 +129,30 @@ int main() {
     // Print the execution time
     printf("Execution Time: %f seconds\n", cpu_time_used);
 
+    // Dynamic mode: keep the cliques and their percolation in a CPM state and absorb a batch
+    // of edge updates ("+ u v" / "- u v" per line) instead of rebuilding from scratch
+    const char* updates_filename = NULL; // e.g. "C:datasets\\updates.txt"
+    if (updates_filename) {
+        int update_count = 0;
+        EdgeUpdate* updates = readEdgeUpdates(updates_filename, V, &update_count);
+        CpmState* state = createCpmState(graph, k);
+
+        start = clock();
+        updateCpmState(state, graph, updates, update_count);
+        cpmStateLabels(state, graph, labels);
+        end = clock();
+        cpu_time_used = ((double)(end - start)) / CLOCKS_PER_SEC;
+
+        printCommunities(labels, V);
+        printf("Modularity: %f\n", calculateModularity(graph, labels, V, graph->E, directed));
+        printf("Conductance: %f\n", calculateConductance(graph, labels, V, directed));
+        printf("Coverage: %f\n", calculateCoverage(graph, labels, V, graph->E, directed));
+        printf("Update Time: %f seconds\n", cpu_time_used);
+
+        freeCpmState(state);
+        free(updates);
+    }
+
     free(labels);
     freeGraph(graph);
 
@@ -1,98 +1,360 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "graph.h"
+#include "components.h"
 
-typedef struct Node {
-    int dest;
-    struct Node* next;
-} Node;
+#define DEGREE_BUCKETS 32
 
-typedef struct Graph {
+// Simple undirected adjacency: neighbors of v are neighbors[offsets[v] .. offsets[v + 1] - 1],
+// sorted, without duplicate edges or self-loops
+typedef struct {
     int V;
-    Node** array;
-} Graph;
-
-// Function to create a new node
-Node* createNode(int dest) {
-    Node* newNode = (Node*)malloc(sizeof(Node));
-    newNode->dest = dest;
-    newNode->next = NULL;
-    return newNode;
+    long long* offsets;
+    int* neighbors;
+} SimpleAdjacency;
+
+int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
 }
 
-// Function to create a graph
-Graph* createGraph(int V) {
-    Graph* graph = (Graph*)malloc(sizeof(Graph));
-    graph->V = V;
-    graph->array = (Node**)malloc(V * sizeof(Node*));
-    for (int i = 0; i < V; ++i) {
-        graph->array[i] = NULL;
+SimpleAdjacency buildSimpleAdjacency(Graph* graph) {
+    SimpleAdjacency adj;
+    int V = graph->V;
+    adj.V = V;
+    adj.offsets = (long long*)calloc(V + 1, sizeof(long long));
+    if (!adj.offsets) {
+        fprintf(stderr, "Memory allocation failed for adjacency offsets\n");
+        exit(1);
     }
-    return graph;
-}
 
-// Function to add an edge to the graph
-void addEdge(Graph* graph, int src, int dest) {
-    Node* newNode = createNode(dest);
-    newNode->next = graph->array[src];
-    graph->array[src] = newNode;
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int v = 0; v < V; ++v) {
+        adj.offsets[v + 1] = vertexDegree(graph, v);
+    }
+    for (int v = 0; v < V; ++v) {
+        adj.offsets[v + 1] += adj.offsets[v];
+    }
 
-    // Since the graph is undirected, add an edge from dest to src also
-    newNode = createNode(src);
-    newNode->next = graph->array[dest];
-    graph->array[dest] = newNode;
-}
+    adj.neighbors = (int*)malloc((adj.offsets[V] > 0 ? adj.offsets[V] : 1) * sizeof(int));
+    int* unique_degree = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    if (!adj.neighbors || !unique_degree) {
+        fprintf(stderr, "Memory allocation failed for adjacency\n");
+        exit(1);
+    }
 
-// Function to read the data file and construct the graph
-Graph* createGraphFromFile(const char* filename, int V) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        printf("Error opening file\n");
-        return NULL;
+    // Copy, sort and deduplicate every list in place
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int v = 0; v < V; ++v) {
+        int* list = adj.neighbors + adj.offsets[v];
+        int count = 0;
+        NeighborIterator it;
+        int u;
+        for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &u);) {
+            if (u != v) {
+                list[count++] = u;
+            }
+        }
+        qsort(list, count, sizeof(int), compareInts);
+        int unique = 0;
+        for (int i = 0; i < count; ++i) {
+            if (unique == 0 || list[i] != list[unique - 1]) {
+                list[unique++] = list[i];
+            }
+        }
+        unique_degree[v] = unique;
     }
 
-    Graph* graph = createGraph(V);
-    int src, dest;
-    while (fscanf(file, "%d %d", &src, &dest) != EOF) {
-        addEdge(graph, src, dest);
+    // Compact the lists
+    long long write = 0;
+    for (int v = 0; v < V; ++v) {
+        long long read = adj.offsets[v];
+        adj.offsets[v] = write;
+        memmove(adj.neighbors + write, adj.neighbors + read, unique_degree[v] * sizeof(int));
+        write += unique_degree[v];
     }
+    adj.offsets[V] = write;
 
-    fclose(file);
-    return graph;
+    free(unique_degree);
+    return adj;
+}
+
+void freeSimpleAdjacency(SimpleAdjacency* adj) {
+    free(adj->offsets);
+    free(adj->neighbors);
 }
 
 // Function to analyze the node degrees
-void analyzeNodeDegrees(Graph* graph) {
-    int* degrees = (int*)calloc(graph->V, sizeof(int));
-    for (int i = 0; i < graph->V; ++i) {
-        Node* node = graph->array[i];
-        while (node) {
-            degrees[i]++;
-            node = node->next;
+void analyzeNodeDegrees(SimpleAdjacency* adj) {
+    int V = adj->V;
+    long long histogram[DEGREE_BUCKETS] = {0};
+    int max_degree = 0;
+    int isolated_nodes = 0;
+
+    #pragma omp parallel
+    {
+        long long local_histogram[DEGREE_BUCKETS] = {0};
+        int local_max = 0;
+        int local_isolated = 0;
+
+        #pragma omp for schedule(static) nowait
+        for (int i = 0; i < V; ++i) {
+            int degree = (int)(adj->offsets[i + 1] - adj->offsets[i]);
+            if (degree == 0) {
+                local_isolated++;
+            }
+            if (degree > local_max) {
+                local_max = degree;
+            }
+            // Bucket b holds degrees in [2^(b-1), 2^b), bucket 0 holds degree 0
+            int bucket = 0;
+            while (degree >> bucket) {
+                bucket++;
+            }
+            local_histogram[bucket]++;
+        }
+
+        #pragma omp critical
+        {
+            for (int b = 0; b < DEGREE_BUCKETS; ++b) {
+                histogram[b] += local_histogram[b];
+            }
+            if (local_max > max_degree) {
+                max_degree = local_max;
+            }
+            isolated_nodes += local_isolated;
         }
     }
 
-    int isolated_nodes = 0;
+    printf("Total nodes: %d\n", V);
+    printf("Total edges: %lld\n", adj->offsets[V] / 2);
+    printf("Isolated nodes: %d\n", isolated_nodes);
+    printf("Percentage of isolated nodes: %.2f%%\n", (isolated_nodes / (double)V) * 100);
+    printf("Maximum degree: %d\n", max_degree);
+    printf("Average degree: %.2f\n", V > 0 ? adj->offsets[V] / (double)V : 0.0);
+
+    printf("Degree distribution:\n");
+    for (int b = 0; b < DEGREE_BUCKETS; ++b) {
+        if (histogram[b] == 0) {
+            continue;
+        }
+        if (b <= 1) {
+            printf("  degree %d: %lld nodes\n", b, histogram[b]);
+        } else {
+            printf("  degree %lld-%lld: %lld nodes\n", 1LL << (b - 1), (1LL << b) - 1, histogram[b]);
+        }
+    }
+}
+
+// Function to analyze the connected components
+void analyzeComponents(Graph* graph) {
+    int* component = (int*)malloc(graph->V * sizeof(int));
+    if (!component) {
+        fprintf(stderr, "Memory allocation failed for components\n");
+        exit(1);
+    }
+    int component_count = connectedComponentsParallel(graph, component);
+
+    int* component_size = (int*)calloc(component_count, sizeof(int));
+    if (!component_size) {
+        fprintf(stderr, "Memory allocation failed for component sizes\n");
+        exit(1);
+    }
     for (int i = 0; i < graph->V; ++i) {
-        if (degrees[i] == 0) {
-            isolated_nodes++;
+        component_size[component[i]]++;
+    }
+    int largest = 0;
+    for (int c = 0; c < component_count; ++c) {
+        if (component_size[c] > largest) {
+            largest = component_size[c];
         }
     }
 
-    printf("Total nodes: %d\n", graph->V);
-    printf("Isolated nodes: %d\n", isolated_nodes);
-    printf("Percentage of isolated nodes: %.2f%%\n", (isolated_nodes / (double)graph->V) * 100);
+    printf("Connected components: %d\n", component_count);
+    printf("Largest component: %d nodes (%.2f%%)\n", largest, (largest / (double)graph->V) * 100);
 
-    free(degrees);
+    free(component_size);
+    free(component);
+}
+
+// Core numbers by parallel h-index iteration: every node repeatedly takes the h-index of
+// its neighbors' current estimates, starting from its degree, until nothing changes.
+// Returns the degeneracy (largest core number).
+int analyzeCoreNumbers(SimpleAdjacency* adj, int* core) {
+    int V = adj->V;
+    int* next = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    int max_degree = 0;
+    if (!next) {
+        fprintf(stderr, "Memory allocation failed for core numbers\n");
+        exit(1);
+    }
+    for (int v = 0; v < V; ++v) {
+        core[v] = (int)(adj->offsets[v + 1] - adj->offsets[v]);
+        if (core[v] > max_degree) {
+            max_degree = core[v];
+        }
+    }
+
+    int rounds = 0;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        rounds++;
+
+        #pragma omp parallel
+        {
+            int* count = (int*)malloc((max_degree + 2) * sizeof(int));
+            if (!count) {
+                fprintf(stderr, "Memory allocation failed for core numbers\n");
+                exit(1);
+            }
+
+            #pragma omp for schedule(dynamic, 256) reduction(|:changed)
+            for (int v = 0; v < V; ++v) {
+                int k = core[v];
+                memset(count, 0, (k + 1) * sizeof(int));
+                for (long long e = adj->offsets[v]; e < adj->offsets[v + 1]; ++e) {
+                    int c = core[adj->neighbors[e]];
+                    count[c < k ? c : k]++;
+                }
+                // Largest h <= k with at least h neighbors whose estimate is >= h
+                int at_least = 0;
+                int h = k;
+                while (h > 0) {
+                    at_least += count[h];
+                    if (at_least >= h) {
+                        break;
+                    }
+                    h--;
+                }
+                next[v] = h;
+                if (h != k) {
+                    changed = 1;
+                }
+            }
+            free(count);
+        }
+
+        memcpy(core, next, V * sizeof(int));
+    }
+
+    int degeneracy = 0;
+    for (int v = 0; v < V; ++v) {
+        if (core[v] > degeneracy) {
+            degeneracy = core[v];
+        }
+    }
+    printf("Core numbers converged after %d rounds\n", rounds);
+    printf("Degeneracy (maximum core number): %d\n", degeneracy);
+    printf("Largest possible clique: %d nodes\n", degeneracy + 1);
+
+    free(next);
+    return degeneracy;
+}
+
+// Triangle count and global clustering coefficient. Each edge is oriented from the lower
+// to the higher (degree, id) rank, so every triangle is found once by merging two short
+// sorted forward lists.
+void analyzeTriangles(SimpleAdjacency* adj) {
+    int V = adj->V;
+    long long* forward_offsets = (long long*)calloc(V + 1, sizeof(long long));
+    if (!forward_offsets) {
+        fprintf(stderr, "Memory allocation failed for triangle counting\n");
+        exit(1);
+    }
+
+    #define DEGREE(x) (adj->offsets[(x) + 1] - adj->offsets[(x)])
+    #define RANKS_BELOW(a, b) (DEGREE(a) < DEGREE(b) || (DEGREE(a) == DEGREE(b) && (a) < (b)))
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int v = 0; v < V; ++v) {
+        long long count = 0;
+        for (long long e = adj->offsets[v]; e < adj->offsets[v + 1]; ++e) {
+            if (RANKS_BELOW(v, adj->neighbors[e])) {
+                count++;
+            }
+        }
+        forward_offsets[v + 1] = count;
+    }
+    for (int v = 0; v < V; ++v) {
+        forward_offsets[v + 1] += forward_offsets[v];
+    }
+    int* forward = (int*)malloc((forward_offsets[V] > 0 ? forward_offsets[V] : 1) * sizeof(int));
+    if (!forward) {
+        fprintf(stderr, "Memory allocation failed for triangle counting\n");
+        exit(1);
+    }
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int v = 0; v < V; ++v) {
+        long long write = forward_offsets[v];
+        for (long long e = adj->offsets[v]; e < adj->offsets[v + 1]; ++e) {
+            if (RANKS_BELOW(v, adj->neighbors[e])) {
+                forward[write++] = adj->neighbors[e];
+            }
+        }
+    }
+
+    long long triangles = 0;
+    long long wedges = 0;
+
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:triangles, wedges)
+    for (int u = 0; u < V; ++u) {
+        long long degree = DEGREE(u);
+        wedges += degree * (degree - 1) / 2;
+        for (long long e = forward_offsets[u]; e < forward_offsets[u + 1]; ++e) {
+            int v = forward[e];
+            long long i = forward_offsets[u];
+            long long j = forward_offsets[v];
+            while (i < forward_offsets[u + 1] && j < forward_offsets[v + 1]) {
+                if (forward[i] < forward[j]) {
+                    i++;
+                } else if (forward[i] > forward[j]) {
+                    j++;
+                } else {
+                    triangles++;
+                    i++;
+                    j++;
+                }
+            }
+        }
+    }
+
+    #undef RANKS_BELOW
+    #undef DEGREE
+
+    printf("Triangles: %lld\n", triangles);
+    printf("Global clustering coefficient: %f\n", wedges > 0 ? 3.0 * triangles / wedges : 0.0);
+
+    free(forward);
+    free(forward_offsets);
 }
 
 int main() {
     int V = 4039; // Number of vertices
     const char* filename = "C:datasets\\facebook_combined.txt"; // Replace with your data file name
 
-    Graph* graph = createGraphFromFile(filename, V);
+    Graph* graph = createGraphFromFile(filename, V, 0);
     if (graph) {
-        analyzeNodeDegrees(graph);
+        SimpleAdjacency adj = buildSimpleAdjacency(graph);
+        int* core = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+        if (!core) {
+            fprintf(stderr, "Memory allocation failed for core numbers\n");
+            exit(1);
+        }
+
+        printf("\n");
+        analyzeNodeDegrees(&adj);
+        analyzeComponents(graph);
+        analyzeCoreNumbers(&adj, core);
+        analyzeTriangles(&adj);
+
+        free(core);
+        freeSimpleAdjacency(&adj);
+        freeGraph(graph);
     }
 
     return 0;
-}
\ No newline at end of file
+}
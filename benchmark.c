@@ -0,0 +1,576 @@
+// benchmark.c
+// Microbenchmarks for the hot kernels: edge list parsing, one label vote pass, isNeighbor,
+// the shared-vertex check of buildCliqueGraph and the three metrics. Every kernel runs on
+// the bundled datasets and on synthetic uniform and power-law graphs, is repeated
+// `repetitions` times and reported as the median time per unit (an adjacency entry, a
+// query or a clique pair) with its standard deviation and the median throughput.
+// Results can be saved as a baseline and later runs compared against it.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "graph.h"
+#include "labelPropagation.h"
+#include "cliquePercolation.h"
+#include "performanceMeasure.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#define NULL_DEVICE "NUL"
+#else
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+#define MAX_RESULTS 128
+
+typedef struct {
+    char name[64];
+    double units;        // Work items per repetition
+    double median_ns;    // Per unit
+    double mean_ns;
+    double stddev_ns;
+} BenchResult;
+
+// State shared by the kernels of one graph
+typedef struct {
+    const char* filename;   // Edge list the graph came from, NULL for synthetic graphs
+    int directed;
+    Graph* graph;
+    long long entries;      // Adjacency entries, the unit of the whole-graph kernels
+    int* labels;
+    int* node_order;
+    int* neighbor_labels;
+    int* scratch;
+    ModeKernel findMode;
+    LpaSweep sweep;
+    int* query_u;           // isNeighbor queries
+    int* query_v;
+    int query_count;
+    CliquePool cliques;
+    int* pair_i;            // Clique pairs for the shared-vertex check
+    int* pair_j;
+    int pair_count;
+    Graph* parsed;          // Graph built by the parse kernel, freed by its prepare step
+} BenchInput;
+
+typedef void (*BenchPrepare)(BenchInput* input);
+typedef long long (*BenchKernel)(BenchInput* input);
+
+volatile long long bench_sink; // Keeps kernel results alive
+
+double nowNanoseconds(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#endif
+}
+
+int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Points stdout at the null device and returns the saved descriptor, or -1 if stdout was
+// left alone. Keeps the loaders' progress messages out of the timings.
+int silenceStdout(void) {
+    fflush(stdout);
+    int saved = dup(fileno(stdout));
+    int null_fd = open(NULL_DEVICE, O_WRONLY);
+    if (saved < 0 || null_fd < 0) {
+        if (saved >= 0) {
+            close(saved);
+        }
+        if (null_fd >= 0) {
+            close(null_fd);
+        }
+        return -1;
+    }
+    dup2(null_fd, fileno(stdout));
+    close(null_fd);
+    return saved;
+}
+
+void restoreStdout(int saved) {
+    if (saved < 0) {
+        return;
+    }
+    fflush(stdout);
+    dup2(saved, fileno(stdout));
+    close(saved);
+}
+
+// Times kernel `repetitions` times after one warm-up run; prepare runs untimed before each.
+// Anything either prints to stdout is discarded.
+void runBenchmark(const char* name, BenchInput* input, BenchPrepare prepare, BenchKernel kernel,
+                  int repetitions, BenchResult* results, int* result_count) {
+    double* samples = (double*)mallocArray(repetitions, sizeof(double), "benchmark samples");
+    long long units = 0;
+    int saved_stdout = silenceStdout();
+    for (int r = -1; r < repetitions; ++r) {
+        if (prepare) {
+            prepare(input);
+        }
+        double start = nowNanoseconds();
+        units = kernel(input);
+        double elapsed = nowNanoseconds() - start;
+        if (r >= 0) {
+            samples[r] = elapsed / (double)(units > 0 ? units : 1);
+        }
+    }
+    restoreStdout(saved_stdout);
+
+    double mean = 0.0;
+    for (int r = 0; r < repetitions; ++r) {
+        mean += samples[r];
+    }
+    mean /= repetitions;
+    double variance = 0.0;
+    for (int r = 0; r < repetitions; ++r) {
+        variance += (samples[r] - mean) * (samples[r] - mean);
+    }
+    qsort(samples, repetitions, sizeof(double), compareDoubles);
+
+    if (*result_count >= MAX_RESULTS) {
+        fprintf(stderr, "Too many benchmark results\n");
+        exit(1);
+    }
+    BenchResult* result = &results[(*result_count)++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->units = (double)units;
+    result->median_ns = repetitions % 2 ? samples[repetitions / 2]
+                                        : 0.5 * (samples[repetitions / 2 - 1] + samples[repetitions / 2]);
+    result->mean_ns = mean;
+    result->stddev_ns = repetitions > 1 ? sqrt(variance / (repetitions - 1)) : 0.0;
+    printf("%-40s %10.2f ns/unit +- %7.2f %10.2f M units/s (%.0f units)\n", result->name, result->median_ns,
+           result->stddev_ns, 1e3 / result->median_ns, result->units);
+    free(samples);
+}
+
+// Kernels
+
+void prepareParse(BenchInput* input) {
+    if (input->parsed) {
+        freeGraph(input->parsed);
+        input->parsed = NULL;
+    }
+}
+
+long long parseKernel(BenchInput* input) {
+    input->parsed = createGraphFromFile(input->filename, input->graph->V, input->directed);
+    return input->parsed->E;
+}
+
+// Every timed pass is a pull sweep over singleton labels, the first sweep of an LPA run
+void prepareVote(BenchInput* input) {
+    initializeLabels(input->labels, input->graph->V);
+    beginLpaSweeps(&input->sweep, input->graph, LPA_OUT_EDGES);
+}
+
+long long voteKernel(BenchInput* input) {
+    bench_sink += relabelSweep(input->graph, input->labels, input->node_order, input->neighbor_labels,
+                               input->scratch, input->findMode, &input->sweep);
+    return input->entries;
+}
+
+long long isNeighborKernel(BenchInput* input) {
+    long long found = 0;
+    for (int q = 0; q < input->query_count; ++q) {
+        found += isNeighbor(input->graph, input->query_u[q], input->query_v[q]);
+    }
+    bench_sink += found;
+    return input->query_count;
+}
+
+long long sharedVerticesKernel(BenchInput* input) {
+    long long shared = 0;
+    for (int p = 0; p < input->pair_count; ++p) {
+        shared += countSharedVertices(&input->cliques, input->pair_i[p], input->pair_j[p]);
+    }
+    bench_sink += shared;
+    return input->pair_count;
+}
+
+long long modularityKernel(BenchInput* input) {
+    Graph* graph = input->graph;
+    bench_sink += (long long)(1e6 * calculateModularity(graph, input->labels, graph->V, graph->E, graph->directed));
+    return input->entries;
+}
+
+long long conductanceKernel(BenchInput* input) {
+    Graph* graph = input->graph;
+    bench_sink += (long long)(1e6 * calculateConductance(graph, input->labels, graph->V, graph->directed));
+    return input->entries;
+}
+
+long long coverageKernel(BenchInput* input) {
+    Graph* graph = input->graph;
+    bench_sink += (long long)(1e6 * calculateCoverage(graph, input->labels, graph->V, graph->E, graph->directed));
+    return input->entries;
+}
+
+// Inputs
+
+// Random graph where every edge joins two uniformly chosen vertices
+Graph* generateUniformGraph(int V, long long edge_count, unsigned int seed) {
+    Graph* graph = createGraph(V, 0);
+    unsigned int rng;
+    seedRandom(&rng, seed);
+    for (long long e = 0; e < edge_count; ++e) {
+        int u = (int)(nextRandom(&rng) % (unsigned int)V);
+        int v = (int)(nextRandom(&rng) % (unsigned int)V);
+        if (u != v) {
+            addEdge(graph, u, v);
+        }
+    }
+    return graph;
+}
+
+// Chung-Lu graph: endpoints are drawn with probability proportional to weights
+// (i + 1)^(-1 / (exponent - 1)), giving a power-law degree distribution
+Graph* generatePowerLawGraph(int V, long long edge_count, double exponent, unsigned int seed) {
+    Graph* graph = createGraph(V, 0);
+    double* cumulative = (double*)mallocArray(V, sizeof(double), "weights");
+    double total = 0.0;
+    for (int i = 0; i < V; ++i) {
+        total += pow(i + 1.0, -1.0 / (exponent - 1.0));
+        cumulative[i] = total;
+    }
+    unsigned int rng;
+    seedRandom(&rng, seed);
+    for (long long e = 0; e < edge_count; ++e) {
+        int endpoint[2];
+        for (int side = 0; side < 2; ++side) {
+            double target = total * (nextRandom(&rng) / 4294967296.0);
+            int low = 0;
+            int high = V - 1;
+            while (low < high) {
+                int mid = (low + high) / 2;
+                if (cumulative[mid] < target) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            endpoint[side] = low;
+        }
+        if (endpoint[0] != endpoint[1]) {
+            addEdge(graph, endpoint[0], endpoint[1]);
+        }
+    }
+    free(cumulative);
+    return graph;
+}
+
+// Grows a maximal clique around v into R and returns its size: the candidates start as
+// the neighbors of v and shrink to the common neighbors of every vertex added. The
+// lowest-degree candidate is added first, so hub adjacency lists are rarely walked.
+int growClique(Graph* graph, int v, const int* degree, int* R, int* P, unsigned char* mark) {
+    int size = 0;
+    int p_size = 0;
+    NeighborIterator it;
+    int u;
+    R[size++] = v;
+    for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &u);) {
+        if (u != v && !mark[u]) {
+            mark[u] = 1;
+            P[p_size++] = u;
+        }
+    }
+    for (int p = 0; p < p_size; ++p) {
+        mark[P[p]] = 0;
+    }
+
+    while (p_size > 0) {
+        int best = 0;
+        for (int p = 1; p < p_size; ++p) {
+            if (degree[P[p]] < degree[P[best]]) {
+                best = p;
+            }
+        }
+        int w = P[best];
+        P[best] = P[--p_size];
+        R[size++] = w;
+        for (neighborIteratorInit(graph, w, &it); neighborIteratorNext(&it, &u);) {
+            mark[u] = 1;
+        }
+        int kept = 0;
+        for (int p = 0; p < p_size; ++p) {
+            if (mark[P[p]]) {
+                P[kept++] = P[p];
+            }
+        }
+        p_size = kept;
+        for (neighborIteratorInit(graph, w, &it); neighborIteratorNext(&it, &u);) {
+            mark[u] = 0;
+        }
+    }
+    return size;
+}
+
+void initBenchInput(BenchInput* input, Graph* graph, const char* filename, int directed, int max_cliques) {
+    memset(input, 0, sizeof(BenchInput));
+    int V = graph->V;
+    input->graph = graph;
+    input->filename = filename;
+    input->directed = directed;
+
+    int max_degree = maxVertexDegree(graph);
+    for (int v = 0; v < V; ++v) {
+        input->entries += vertexDegree(graph, v);
+    }
+    input->labels = (int*)mallocArray(V, sizeof(int), "labels");
+    input->node_order = (int*)mallocArray(V, sizeof(int), "node order");
+    input->neighbor_labels = (int*)mallocArray((size_t)max_degree + 1, sizeof(int), "neighbor labels");
+    input->scratch = (int*)mallocArray((size_t)max_degree + 1, sizeof(int), "vote scratch");
+    input->findMode = selectModeKernel();
+    initLpaSweep(&input->sweep, V);
+    unsigned int rng;
+    seedRandom(&rng, 3000);
+    for (int i = 0; i < V; ++i) {
+        input->node_order[i] = i;
+    }
+    shuffleWithState(input->node_order, V, &rng);
+
+    // Half of the queries are edges, half are random pairs
+    input->query_count = 1 << 16;
+    input->query_u = (int*)mallocArray(input->query_count, sizeof(int), "queries");
+    input->query_v = (int*)mallocArray(input->query_count, sizeof(int), "queries");
+    for (int q = 0; q < input->query_count; ++q) {
+        int u = (int)(nextRandom(&rng) % (unsigned int)V);
+        int v = (int)(nextRandom(&rng) % (unsigned int)V);
+        int degree = vertexDegree(graph, u);
+        if (q % 2 == 0 && degree > 0) {
+            int pick = (int)(nextRandom(&rng) % (unsigned int)degree);
+            NeighborIterator it;
+            int dest;
+            for (neighborIteratorInit(graph, u, &it); neighborIteratorNext(&it, &dest) && pick >= 0; --pick) {
+                v = dest;
+            }
+        }
+        input->query_u[q] = u;
+        input->query_v[q] = v;
+    }
+
+    // Enumerating every maximal clique of a dense graph such as facebook_combined takes far
+    // longer than the benchmark, so cliques are grown greedily from random vertices instead.
+    // Every other clique starts from a neighbor of the previous seed, and half of the pairs
+    // are such consecutive cliques, which usually share vertices like the pairs
+    // buildCliqueGraph keeps.
+    initCliquePool(&input->cliques, max_cliques, (long long)max_cliques * 8);
+    if (!graph->directed && V > 0) {
+        int* R = (int*)mallocArray(V, sizeof(int), "clique growth");
+        int* P = (int*)mallocArray(V, sizeof(int), "clique growth");
+        unsigned char* mark = (unsigned char*)callocArray(V, sizeof(unsigned char), "clique growth");
+        int* degree = (int*)mallocArray(V, sizeof(int), "clique growth");
+        for (int v = 0; v < V; ++v) {
+            degree[v] = vertexDegree(graph, v);
+        }
+        int seed_vertex = 0;
+        for (int c = 0; c < max_cliques; ++c) {
+            int next = (int)(nextRandom(&rng) % (unsigned int)V);
+            if (c % 2 == 1 && degree[seed_vertex] > 0) {
+                NeighborIterator it;
+                neighborIteratorInit(graph, seed_vertex, &it);
+                neighborIteratorNext(&it, &next);
+            }
+            seed_vertex = next;
+            int size = growClique(graph, seed_vertex, degree, R, P, mark);
+            if (size >= 3) {
+                addClique(&input->cliques, R, size);
+            }
+        }
+        free(R);
+        free(P);
+        free(mark);
+        free(degree);
+    }
+    int clique_count = input->cliques.count;
+    input->pair_count = clique_count > 1 ? 1 << 16 : 0;
+    input->pair_i = (int*)mallocArray(input->pair_count, sizeof(int), "clique pairs");
+    input->pair_j = (int*)mallocArray(input->pair_count, sizeof(int), "clique pairs");
+    for (int p = 0; p < input->pair_count; ++p) {
+        int i = (int)(nextRandom(&rng) % (unsigned int)clique_count);
+        int j = (int)(nextRandom(&rng) % (unsigned int)clique_count);
+        if (p % 2 == 0) {
+            j = i + 1 < clique_count ? i + 1 : i - 1;
+        }
+        input->pair_i[p] = i;
+        input->pair_j[p] = j;
+    }
+}
+
+void freeBenchInput(BenchInput* input) {
+    prepareParse(input);
+    free(input->labels);
+    free(input->node_order);
+    free(input->neighbor_labels);
+    free(input->scratch);
+    freeLpaSweep(&input->sweep);
+    free(input->query_u);
+    free(input->query_v);
+    freeCliquePool(&input->cliques);
+    free(input->pair_i);
+    free(input->pair_j);
+    freeGraph(input->graph);
+}
+
+void benchmarkGraph(const char* graph_name, BenchInput* input, int repetitions,
+                    BenchResult* results, int* result_count) {
+    char name[64];
+    printf("\n%s: %d vertices, %lld adjacency entries, %d cliques\n", graph_name, input->graph->V,
+           input->entries, input->cliques.count);
+    if (input->filename) {
+        snprintf(name, sizeof(name), "parse/%s", graph_name);
+        runBenchmark(name, input, prepareParse, parseKernel, repetitions, results, result_count);
+        prepareParse(input);
+    }
+    snprintf(name, sizeof(name), "vote/%s", graph_name);
+    runBenchmark(name, input, prepareVote, voteKernel, repetitions, results, result_count);
+    snprintf(name, sizeof(name), "isNeighbor/%s", graph_name);
+    runBenchmark(name, input, NULL, isNeighborKernel, repetitions, results, result_count);
+    if (input->pair_count > 0) {
+        snprintf(name, sizeof(name), "sharedVertices/%s", graph_name);
+        runBenchmark(name, input, NULL, sharedVerticesKernel, repetitions, results, result_count);
+    }
+
+    // The metrics are timed on the labels of a few LPA passes; a full run could take up to
+    // MAX_ITER passes on the uniform graph, which has no community structure to converge to
+    initializeLabels(input->labels, input->graph->V);
+    beginLpaSweeps(&input->sweep, input->graph, LPA_OUT_EDGES);
+    for (int pass = 0; pass < 5; ++pass) {
+        relabelSweep(input->graph, input->labels, input->node_order, input->neighbor_labels, input->scratch,
+                     input->findMode, &input->sweep);
+    }
+    snprintf(name, sizeof(name), "modularity/%s", graph_name);
+    runBenchmark(name, input, NULL, modularityKernel, repetitions, results, result_count);
+    snprintf(name, sizeof(name), "conductance/%s", graph_name);
+    runBenchmark(name, input, NULL, conductanceKernel, repetitions, results, result_count);
+    snprintf(name, sizeof(name), "coverage/%s", graph_name);
+    runBenchmark(name, input, NULL, coverageKernel, repetitions, results, result_count);
+}
+
+// Baseline files hold one "name median_ns stddev_ns" line per result
+
+void saveBaseline(const char* filename, const BenchResult* results, int result_count) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Unable to open file %s\n", filename);
+        exit(1);
+    }
+    for (int i = 0; i < result_count; ++i) {
+        fprintf(file, "%s %.6f %.6f\n", results[i].name, results[i].median_ns, results[i].stddev_ns);
+    }
+    fclose(file);
+    printf("\nBaseline saved to %s.\n", filename);
+}
+
+// A change counts only when it exceeds both threshold_percent and twice the combined
+// standard deviation of the two runs
+void compareBaseline(const char* filename, const BenchResult* results, int result_count, double threshold_percent) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Unable to open file %s\n", filename);
+        exit(1);
+    }
+    printf("\nComparison with %s:\n", filename);
+    char name[64];
+    double median, stddev;
+    int matched = 0;
+    while (fscanf(file, "%63s %lf %lf", name, &median, &stddev) == 3) {
+        for (int i = 0; i < result_count; ++i) {
+            if (strcmp(results[i].name, name) != 0) {
+                continue;
+            }
+            double change = 100.0 * (results[i].median_ns - median) / median;
+            double noise = 2.0 * sqrt(stddev * stddev + results[i].stddev_ns * results[i].stddev_ns);
+            const char* verdict = "unchanged";
+            if (fabs(change) > threshold_percent && fabs(results[i].median_ns - median) > noise) {
+                verdict = change < 0 ? "faster" : "SLOWER";
+            }
+            printf("%-40s %10.2f -> %10.2f ns/unit %+7.1f%%  %s\n", name, median, results[i].median_ns, change, verdict);
+            matched++;
+        }
+    }
+    fclose(file);
+    printf("%d of %d benchmarks matched the baseline.\n", matched, result_count);
+}
+
+int fileExists(const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (file) {
+        fclose(file);
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    int repetitions = 9;
+
+    // Baseline handling: save this run as the baseline, or compare against an existing one
+    const char* baseline_filename = "benchmark_baseline.txt";
+    int save_baseline = 0;
+    double threshold_percent = 10.0;
+
+    // Bundled datasets; missing files are skipped
+    const char* dataset_names[] = { "facebook_combined", "outego-facebook", "outego-twitter", "outego-gplus" };
+    const char* dataset_files[] = { "C:datasets\\facebook_combined.txt", "C:datasets\\outego-facebook.txt",
+                                    "C:datasets\\outego-twitter.txt", "C:datasets\\outego-gplus.txt" };
+    int dataset_V[] = { 4039, 2890, 23370, 23629 };
+    int dataset_directed[] = { 0, 0, 1, 1 };
+    int dataset_count = 4;
+
+    // Synthetic graphs with the same vertex and edge budget and different degree spreads
+    int synthetic_V = 50000;
+    long long synthetic_edges = 500000;
+
+    // Cliques grown per graph for the shared-vertex check
+    int max_cliques = 8192;
+
+    BenchResult* results = (BenchResult*)mallocArray(MAX_RESULTS, sizeof(BenchResult), "benchmark results");
+    int result_count = 0;
+    BenchInput input;
+
+    for (int d = 0; d < dataset_count; ++d) {
+        if (!fileExists(dataset_files[d])) {
+            printf("Skipping %s: %s not found.\n", dataset_names[d], dataset_files[d]);
+            continue;
+        }
+        Graph* graph = createGraphFromFile(dataset_files[d], dataset_V[d], dataset_directed[d]);
+        initBenchInput(&input, graph, dataset_files[d], dataset_directed[d], max_cliques);
+        benchmarkGraph(dataset_names[d], &input, repetitions, results, &result_count);
+        freeBenchInput(&input);
+    }
+
+    initBenchInput(&input, generateUniformGraph(synthetic_V, synthetic_edges, 1), NULL, 0, max_cliques);
+    benchmarkGraph("uniform", &input, repetitions, results, &result_count);
+    freeBenchInput(&input);
+
+    initBenchInput(&input, generatePowerLawGraph(synthetic_V, synthetic_edges, 2.1, 2), NULL, 0, max_cliques);
+    benchmarkGraph("powerlaw", &input, repetitions, results, &result_count);
+    freeBenchInput(&input);
+
+    if (save_baseline) {
+        saveBaseline(baseline_filename, results, result_count);
+    } else if (fileExists(baseline_filename)) {
+        compareBaseline(baseline_filename, results, result_count, threshold_percent);
+    }
+
+    free(results);
+    return 0;
+}
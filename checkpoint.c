@@ -0,0 +1,108 @@
+// checkpoint.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "checkpoint.h"
+#include "graph.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#define MAGIC_LENGTH 8
+
+int beginCheckpoint(CheckpointWriter* writer, const char* path, const char* magic) {
+    size_t length = strlen(path);
+    writer->path = (char*)malloc(length + 1);
+    writer->tmp_path = (char*)malloc(length + 5);
+    if (!writer->path || !writer->tmp_path) {
+        fprintf(stderr, "Memory allocation failed for checkpoint path\n");
+        exit(1);
+    }
+    memcpy(writer->path, path, length + 1);
+    memcpy(writer->tmp_path, path, length);
+    memcpy(writer->tmp_path + length, ".tmp", 5);
+
+    writer->failed = 0;
+    writer->file = fopen(writer->tmp_path, "wb");
+    if (!writer->file) {
+        fprintf(stderr, "Unable to write checkpoint %s; continuing without it\n", writer->tmp_path);
+        free(writer->path);
+        free(writer->tmp_path);
+        return 0;
+    }
+    writeCheckpoint(writer, magic, 1, MAGIC_LENGTH);
+    return 1;
+}
+
+void writeCheckpoint(CheckpointWriter* writer, const void* data, size_t size, size_t count) {
+    if (!writer->failed && fwrite(data, size, count, writer->file) != count) {
+        writer->failed = 1;
+    }
+}
+
+int commitCheckpoint(CheckpointWriter* writer) {
+    int ok = !writer->failed && fflush(writer->file) == 0;
+#ifndef _WIN32
+    // The data must reach the disk before the rename makes it the current checkpoint
+    if (ok && fsync(fileno(writer->file)) != 0) {
+        ok = 0;
+    }
+#endif
+    if (fclose(writer->file) != 0) {
+        ok = 0;
+    }
+    if (ok) {
+#ifdef _WIN32
+        remove(writer->path); // rename does not replace an existing file on Windows
+#endif
+        ok = rename(writer->tmp_path, writer->path) == 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "Checkpoint write to %s failed; keeping the previous checkpoint\n", writer->path);
+        remove(writer->tmp_path);
+    }
+    free(writer->path);
+    free(writer->tmp_path);
+    writer->file = NULL;
+    return ok;
+}
+
+FILE* openCheckpoint(const char* path, const char* magic) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    char found[MAGIC_LENGTH];
+    if (fread(found, 1, MAGIC_LENGTH, file) != MAGIC_LENGTH || memcmp(found, magic, MAGIC_LENGTH) != 0) {
+        fprintf(stderr, "%s is not a valid checkpoint; ignoring it\n", path);
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+int readCheckpoint(FILE* file, void* data, size_t size, size_t count) {
+    return fread(data, size, count, file) == count;
+}
+
+// Elements read per step by readCheckpointArray
+#define READ_CHUNK (1 << 20)
+
+int readCheckpointArray(FILE* file, void** data, size_t size, long long count, const char* what) {
+    long long done = 0;
+    long long capacity = 0;
+    while (done < count) {
+        long long chunk = count - done < READ_CHUNK ? count - done : READ_CHUNK;
+        if (done + chunk > capacity) {
+            capacity = 2 * capacity > done + chunk ? 2 * capacity : done + chunk;
+            capacity = capacity < count ? capacity : count;
+            *data = reallocArray(*data, (size_t)capacity, size, what);
+        }
+        if (!readCheckpoint(file, (char*)*data + done * size, size, (size_t)chunk)) {
+            return 0;
+        }
+        done += chunk;
+    }
+    return 1;
+}
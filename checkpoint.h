@@ -0,0 +1,31 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+
+// Checkpoints are compact binary files starting with an 8-byte magic. They are written
+// to path + ".tmp" and renamed over path only once complete, so a job preempted in the
+// middle of a write still finds the previous checkpoint.
+typedef struct {
+    FILE* file;
+    char* path;
+    char* tmp_path;
+    int failed;
+} CheckpointWriter;
+
+// A failed checkpoint write is reported and skipped rather than ending the run:
+// beginCheckpoint and commitCheckpoint return 0 and the previous checkpoint is kept
+int beginCheckpoint(CheckpointWriter* writer, const char* path, const char* magic);
+void writeCheckpoint(CheckpointWriter* writer, const void* data, size_t size, size_t count);
+int commitCheckpoint(CheckpointWriter* writer);
+
+// Returns NULL when path does not exist or holds another kind of file
+FILE* openCheckpoint(const char* path, const char* magic);
+// Returns 1 when all count items were read
+int readCheckpoint(FILE* file, void* data, size_t size, size_t count);
+// Reads count items into *data, a malloc'd array or NULL, growing it as the items arrive,
+// so a corrupt count fails at the end of the file instead of allocating for all of them.
+// Returns 1 when all count items were read; *data must be freed either way.
+int readCheckpointArray(FILE* file, void** data, size_t size, long long count, const char* what);
+
+#endif // CHECKPOINT_H
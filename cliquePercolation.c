@@ -0,0 +1,1158 @@
+// cliquePercolation.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "cliquePercolation.h"
+#include "components.h"
+#include "checkpoint.h"
+
+void initCliquePool(CliquePool* pool, int clique_capacity, long long vertex_capacity) {
+    pool->count = 0;
+    pool->clique_capacity = clique_capacity > 0 ? clique_capacity : 1;
+    pool->vertex_capacity = vertex_capacity > 0 ? vertex_capacity : 1;
+    pool->vertices = (int*)mallocArray(pool->vertex_capacity, sizeof(int), "clique vertices");
+    pool->offsets = (long long*)mallocArray((size_t)pool->clique_capacity + 1, sizeof(long long), "clique offsets");
+    pool->offsets[0] = 0;
+}
+
+// Releases every clique of the pool at once
+void freeCliquePool(CliquePool* pool) {
+    free(pool->vertices);
+    free(pool->offsets);
+    pool->vertices = NULL;
+    pool->offsets = NULL;
+    pool->count = 0;
+}
+
+void addClique(CliquePool* pool, const int* R, int size) {
+    if (pool->count >= pool->clique_capacity) {
+        if (pool->clique_capacity > INT_MAX / 2) {
+            fprintf(stderr, "Clique pool exceeds %d cliques\n", INT_MAX);
+            exit(1);
+        }
+        pool->clique_capacity *= 2;
+        pool->offsets = (long long*)reallocArray(pool->offsets, (size_t)pool->clique_capacity + 1, sizeof(long long), "clique offsets");
+    }
+    long long start = pool->offsets[pool->count];
+    while (start + size > pool->vertex_capacity) {
+        pool->vertex_capacity *= 2;
+        pool->vertices = (int*)reallocArray(pool->vertices, pool->vertex_capacity, sizeof(int), "clique vertices");
+    }
+
+    memcpy(pool->vertices + start, R, size * sizeof(int));
+    pool->offsets[pool->count + 1] = start + size;
+    pool->count++;
+}
+
+
+bool isNeighbor(Graph* graph, int u, int v) {
+    NeighborIterator it;
+    int w;
+    for (neighborIteratorInit(graph, u, &it); neighborIteratorNext(&it, &w);) {
+        if (w == v) return true;
+    }
+    return false;
+}
+void findTriangles(Graph* graph, int* labels, CliquePool* cliques) {
+    printf("Running find triangles...\n");
+    int V = graph->V;
+
+    for (int u = 0; u < V; u++) {
+        NeighborIterator neighbor;
+        int v;
+        for (neighborIteratorInit(graph, u, &neighbor); neighborIteratorNext(&neighbor, &v);) {
+            if (v > u) { // Avoid duplicate triangle counting
+                NeighborIterator neighbor2;
+                int w;
+                for (neighborIteratorInit(graph, v, &neighbor2); neighborIteratorNext(&neighbor2, &w);) {
+                    if (w > v && isNeighbor(graph, u, w)) {
+                        printf("Triangle found: %d, %d, %d\n", u, v, w);
+
+                        int triangle[3] = {u, v, w};
+                        addClique(cliques, triangle, 3);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Set mark[w] = value for every neighbor w of u (self-loops are skipped)
+void markNeighbors(Graph* graph, int u, unsigned char* mark, unsigned char value) {
+    NeighborIterator it;
+    int w;
+    for (neighborIteratorInit(graph, u, &it); neighborIteratorNext(&it, &w);) {
+        if (w != u) {
+            mark[w] = value;
+        }
+    }
+}
+
+// Enumerates the maximal cliques extending R (r_size vertices) with candidates P and
+// excluded vertices X. Only cliques with at least min_size vertices are stored.
+// X must have room for x_size + p_size entries; mark is a zeroed V-sized scratch array.
+void BronKerboschPivot(Graph* graph, int* R, int r_size, int* P, int p_size, int* X, int x_size,
+                       unsigned char* mark, int min_size, CliquePool* cliques) {
+    if (p_size == 0) {
+        if (x_size == 0 && r_size >= min_size) {
+            // Found a maximal clique
+            addClique(cliques, R, r_size);
+        }
+        return;
+    }
+    if (r_size + p_size < min_size) {
+        return; // No clique reachable from here can be large enough
+    }
+
+    // Choose the pivot in P u X with the most neighbors in P
+    int pivot = -1;
+    int max_count = -1;
+    for (int i = 0; i < p_size + x_size; i++) {
+        int u = (i < p_size) ? P[i] : X[i - p_size];
+        markNeighbors(graph, u, mark, 1);
+        int count = 0;
+        for (int j = 0; j < p_size; j++) {
+            count += mark[P[j]];
+        }
+        markNeighbors(graph, u, mark, 0);
+        if (count > max_count) {
+            max_count = count;
+            pivot = u;
+        }
+    }
+
+    // Only vertices outside the pivot's neighborhood need to be branched on
+    int* candidates = (int*)malloc(p_size * sizeof(int));
+    int* newP = (int*)malloc(p_size * sizeof(int));
+    int* newX = (int*)malloc((x_size + p_size) * sizeof(int));
+    if (!candidates || !newP || !newX) {
+        fprintf(stderr, "Memory allocation failed in BronKerboschPivot\n");
+        exit(1);
+    }
+    int candidate_count = 0;
+    markNeighbors(graph, pivot, mark, 1);
+    for (int i = 0; i < p_size; i++) {
+        if (!mark[P[i]]) {
+            candidates[candidate_count++] = P[i];
+        }
+    }
+    markNeighbors(graph, pivot, mark, 0);
+
+    for (int c = 0; c < candidate_count; c++) {
+        int u = candidates[c];
+        R[r_size] = u;
+
+        // newP = P n N(u), newX = X n N(u)
+        markNeighbors(graph, u, mark, 1);
+        int newP_size = 0;
+        int newX_size = 0;
+        for (int i = 0; i < p_size; i++) {
+            if (mark[P[i]]) {
+                newP[newP_size++] = P[i];
+            }
+        }
+        for (int i = 0; i < x_size; i++) {
+            if (mark[X[i]]) {
+                newX[newX_size++] = X[i];
+            }
+        }
+        markNeighbors(graph, u, mark, 0);
+
+        BronKerboschPivot(graph, R, r_size + 1, newP, newP_size, newX, newX_size,
+                          mark, min_size, cliques);
+
+        // Move u from P to X
+        for (int i = 0; i < p_size; i++) {
+            if (P[i] == u) {
+                P[i] = P[--p_size];
+                break;
+            }
+        }
+        X[x_size++] = u;
+    }
+
+    free(candidates);
+    free(newP);
+    free(newX);
+}
+
+// Runs the Bron-Kerbosch search rooted at v: P holds v's later neighbors and X its earlier
+// ones. R, P and X must hold V entries and mark must be a zeroed V-sized array.
+void findCliquesFromRoot(Graph* graph, int v, int* R, int* P, int* X, unsigned char* mark, int k, CliquePool* cliques) {
+    int p_size = 0;
+    int x_size = 0;
+    NeighborIterator it;
+    int u;
+    for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &u);) {
+        if (u != v && !mark[u]) { // Skip self-loops and duplicate edges
+            mark[u] = 1;
+            if (u > v) {
+                P[p_size++] = u;
+            } else {
+                X[x_size++] = u;
+            }
+        }
+    }
+    markNeighbors(graph, v, mark, 0);
+
+    R[0] = v;
+    BronKerboschPivot(graph, R, 1, P, p_size, X, x_size, mark, k, cliques);
+}
+
+// Enumerates every maximal clique with at least k vertices. Each vertex v is used as the
+// root of one Bron-Kerbosch search over its later neighbors, with its earlier neighbors
+// excluded, so every maximal clique is reported exactly once.
+void findCliques(Graph* graph, int k, int* labels, CliquePool* cliques) {
+    printf("Finding maximal cliques of size >= %d...\n", k);
+    int V = graph->V;
+
+    int* R = (int*)malloc(V * sizeof(int));
+    int* P = (int*)malloc(V * sizeof(int));
+    int* X = (int*)malloc(V * sizeof(int));
+    unsigned char* mark = (unsigned char*)calloc(V, sizeof(unsigned char));
+    if (!R || !P || !X || !mark) {
+        fprintf(stderr, "Memory allocation failed in findCliques\n");
+        exit(1);
+    }
+
+    for (int v = 0; v < V; v++) {
+        findCliquesFromRoot(graph, v, R, P, X, mark, k, cliques);
+    }
+
+    free(R);
+    free(P);
+    free(X);
+    free(mark);
+
+    printf("Cliques found: %d\n", cliques->count);
+}
+
+void addCliqueEdge(Graph* clique_graph, int i, int j) {
+    addEdge(clique_graph, i, j);
+}
+int countSharedVertices(const CliquePool* cliques, int i, int j) {
+    int* vertices_i = cliqueVertices(cliques, i);
+    int* vertices_j = cliqueVertices(cliques, j);
+    int size_i = cliqueSize(cliques, i);
+    int size_j = cliqueSize(cliques, j);
+
+    int shared_vertices = 0;
+    for (int vi = 0; vi < size_i; ++vi) {
+        for (int vj = 0; vj < size_j; ++vj) {
+            if (vertices_i[vi] == vertices_j[vj]) {
+                shared_vertices++;
+            }
+        }
+    }
+    return shared_vertices;
+}
+
+bool hasValidClique(const CliquePool* cliques, int i, int k) {
+    return cliqueSize(cliques, i) >= k;
+}
+
+Graph* buildCliqueGraph(CliquePool* cliques, int k, int directed) {
+    printf("Building clique graph...\n");
+
+    int clique_count = cliques->count;
+
+    // Step 1: Create the clique graph
+    Graph* clique_graph = createGraph(clique_count, directed);
+
+    // Step 2: Loop through cliques and skip those smaller than k
+    for (int i = 0; i < clique_count; ++i) {
+        if (!hasValidClique(cliques, i, k)) {
+            continue;  // Skip invalid clique
+        }
+
+        for (int j = i + 1; j < clique_count; ++j) {
+            if (!hasValidClique(cliques, j, k)) {
+                continue;  // Skip invalid clique
+            }
+
+            // Step 3: Count the vertices the two cliques share
+            int shared_vertices = countSharedVertices(cliques, i, j);
+
+            // Step 4: Add edge if necessary (based on shared vertices)
+            if (shared_vertices >= k - 1) {
+                addCliqueEdge(clique_graph, i, j);
+            }
+        }
+    }
+
+    printf("Clique graph built\n");
+    return clique_graph;
+}
+
+void decomposeGraph(Graph* graph, int* component, int* component_count) {
+    printf("Decomposing graph into connected components...\n");
+    *component_count = connectedComponentsParallel(graph, component);
+    printf("Graph decomposed.\n");
+}
+
+void mapCliquesToNodes(int* labels, CliquePool* cliques, int* component_labels) {
+    printf("Mapping cliques to original graph...\n");
+
+    // Map each node in the cliques to its component
+    for (int i = 0; i < cliques->count; ++i) {
+        int component = component_labels[i];  // The component of the current clique
+        int* vertices = cliqueVertices(cliques, i);
+        int size = cliqueSize(cliques, i);
+        for (int j = 0; j < size; ++j) {
+            labels[vertices[j]] = component;
+        }
+    }
+
+    printf("Cliques mapped.\n");
+}
+
+void cliqueCommunity(Graph* graph, int k, int* labels, int directed) {
+    printf("Running clique community detection...\n");
+    CliquePool cliques;
+    initCliquePool(&cliques, graph->V, (long long)graph->V * k);
+    findCliques(graph, k, labels, &cliques);
+    int clique_count = cliques.count;
+
+    Graph* clique_graph = buildCliqueGraph(&cliques, k, directed);
+
+    int* component = (int*)malloc(clique_count * sizeof(int));
+    int component_count = 0;
+    decomposeGraph(clique_graph, component, &component_count);
+
+    // Print the component array to verify component labels
+    // printf("Component labels:\n");
+    // for (int i = 0; i < clique_count; ++i) {
+    //     printf("Clique %d -> Component %d\n", i, component[i]);
+    // }
+
+   // Call the mapCliquesToNodes function
+    mapCliquesToNodes(labels, &cliques, component);
+
+    // Free allocated memory
+    freeCliquePool(&cliques);
+    free(component);
+    freeGraph(clique_graph);
+    printf("Clique community detection completed.\n");
+}
+
+int findSet(int* parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]]; // Path halving
+        x = parent[x];
+    }
+    return x;
+}
+
+void unionSets(int* parent, int a, int b) {
+    int ra = findSet(parent, a);
+    int rb = findSet(parent, b);
+    if (ra < rb) {
+        parent[rb] = ra;
+    } else if (rb < ra) {
+        parent[ra] = rb;
+    }
+}
+
+// Runs CPM for every k in [k_min, k_max] from a single maximal clique enumeration.
+// labels_per_k[k - k_min] receives the V node labels for that k (-1 = no community).
+// Two maximal cliques overlapping in o vertices are adjacent for every k <= o + 1, so the
+// clique overlaps are computed once and merged into one union-find from k_max down to
+// k_min. The communities found for k + 1 are therefore nested inside those found for k.
+void cliqueCommunitySweep(Graph* graph, int k_min, int k_max, int** labels_per_k) {
+    printf("Running clique community sweep for k = %d..%d...\n", k_min, k_max);
+    int V = graph->V;
+    CliquePool pool;
+    initCliquePool(&pool, V, (long long)V * k_min);
+    findCliques(graph, k_min, NULL, &pool);
+    CliquePool* cliques = &pool;
+    int clique_count = pool.count;
+
+    // Index the cliques each vertex belongs to
+    long long* incidence_start = (long long*)callocArray((size_t)V + 1, sizeof(long long), "clique incidence");
+    for (int c = 0; c < clique_count; ++c) {
+        int* vertices = cliqueVertices(cliques, c);
+        for (int j = 0; j < cliqueSize(cliques, c); ++j) {
+            incidence_start[vertices[j] + 1]++;
+        }
+    }
+    for (int v = 0; v < V; ++v) {
+        incidence_start[v + 1] += incidence_start[v];
+    }
+    int* incidence = (int*)mallocArray(incidence_start[V], sizeof(int), "clique incidence");
+    long long* fill = (long long*)mallocArray(V, sizeof(long long), "clique incidence");
+    memcpy(fill, incidence_start, V * sizeof(long long));
+    for (int c = 0; c < clique_count; ++c) {
+        int* vertices = cliqueVertices(cliques, c);
+        for (int j = 0; j < cliqueSize(cliques, c); ++j) {
+            int v = vertices[j];
+            incidence[fill[v]++] = c;
+        }
+    }
+    free(fill);
+
+    // Bucket every overlapping clique pair by the largest k at which it percolates
+    int levels = k_max - k_min + 1;
+    long long* pair_count = (long long*)calloc(levels, sizeof(long long));
+    long long* pair_capacity = (long long*)malloc(levels * sizeof(long long));
+    int** pairs = (int**)malloc(levels * sizeof(int*));
+    int* overlap = (int*)calloc(clique_count > 0 ? clique_count : 1, sizeof(int));
+    int* touched = (int*)malloc((clique_count > 0 ? clique_count : 1) * sizeof(int));
+    if (!pair_count || !pair_capacity || !pairs || !overlap || !touched) {
+        fprintf(stderr, "Memory allocation failed for clique overlaps\n");
+        exit(1);
+    }
+    for (int l = 0; l < levels; ++l) {
+        pair_capacity[l] = 16;
+        pairs[l] = (int*)mallocArray(2 * pair_capacity[l], sizeof(int), "clique pairs");
+    }
+
+    for (int i = 0; i < clique_count; ++i) {
+        int touched_count = 0;
+        int* vertices = cliqueVertices(cliques, i);
+        for (int j = 0; j < cliqueSize(cliques, i); ++j) {
+            int v = vertices[j];
+            for (long long e = incidence_start[v]; e < incidence_start[v + 1]; ++e) {
+                int c = incidence[e];
+                if (c > i) {
+                    if (overlap[c] == 0) {
+                        touched[touched_count++] = c;
+                    }
+                    overlap[c]++;
+                }
+            }
+        }
+        for (int t = 0; t < touched_count; ++t) {
+            int c = touched[t];
+            int k_top = overlap[c] + 1; // Both cliques have more than overlap[c] vertices
+            overlap[c] = 0;
+            if (k_top < k_min) {
+                continue;
+            }
+            int level = (k_top > k_max ? k_max : k_top) - k_min;
+            if (pair_count[level] >= pair_capacity[level]) {
+                pair_capacity[level] *= 2;
+                pairs[level] = (int*)reallocArray(pairs[level], 2 * pair_capacity[level], sizeof(int), "clique pairs");
+            }
+            pairs[level][2 * pair_count[level]] = i;
+            pairs[level][2 * pair_count[level] + 1] = c;
+            pair_count[level]++;
+        }
+    }
+    free(overlap);
+
+    // Percolate from the largest k down, reusing the union-find between levels
+    int* parent = (int*)malloc((clique_count > 0 ? clique_count : 1) * sizeof(int));
+    int* component_id = touched; // Reused as root -> community id map
+    if (!parent) {
+        fprintf(stderr, "Memory allocation failed for union-find\n");
+        exit(1);
+    }
+    for (int c = 0; c < clique_count; ++c) {
+        parent[c] = c;
+    }
+
+    for (int k = k_max; k >= k_min; --k) {
+        int level = k - k_min;
+        for (long long p = 0; p < pair_count[level]; ++p) {
+            unionSets(parent, pairs[level][2 * p], pairs[level][2 * p + 1]);
+        }
+
+        // Number communities in order of their first clique, as decomposeGraph does
+        int* labels = labels_per_k[level];
+        for (int v = 0; v < V; ++v) {
+            labels[v] = -1;
+        }
+        for (int c = 0; c < clique_count; ++c) {
+            component_id[c] = -1;
+        }
+        int community_count = 0;
+        for (int c = 0; c < clique_count; ++c) {
+            if (cliqueSize(cliques, c) < k) {
+                continue;
+            }
+            int root = findSet(parent, c);
+            if (component_id[root] < 0) {
+                component_id[root] = community_count++;
+            }
+            int* vertices = cliqueVertices(cliques, c);
+            for (int j = 0; j < cliqueSize(cliques, c); ++j) {
+                labels[vertices[j]] = component_id[root];
+            }
+        }
+        printf("k = %d: %d communities\n", k, community_count);
+    }
+
+    for (int l = 0; l < levels; ++l) {
+        free(pairs[l]);
+    }
+    free(pairs);
+    free(pair_count);
+    free(pair_capacity);
+    free(parent);
+    free(touched);
+    free(incidence);
+    free(incidence_start);
+    freeCliquePool(&pool);
+    printf("Clique community sweep completed.\n");
+}
+
+// Grows the per-clique arrays of the state to cover every clique in its pool
+void ensureCpmCapacity(CpmState* state) {
+    if (state->cliques.count <= state->capacity) {
+        return;
+    }
+    int old_capacity = state->capacity;
+    int capacity = old_capacity > 0 ? old_capacity : 1024;
+    while (capacity < state->cliques.count) {
+        capacity *= 2;
+    }
+    state->alive = (unsigned char*)realloc(state->alive, capacity * sizeof(unsigned char));
+    state->parent = (int*)realloc(state->parent, capacity * sizeof(int));
+    state->overlap = (int*)realloc(state->overlap, capacity * sizeof(int));
+    state->touched = (int*)realloc(state->touched, capacity * sizeof(int));
+    if (!state->alive || !state->parent || !state->overlap || !state->touched) {
+        fprintf(stderr, "Memory allocation failed for CPM state\n");
+        exit(1);
+    }
+    memset(state->overlap + old_capacity, 0, (capacity - old_capacity) * sizeof(int));
+    state->capacity = capacity;
+}
+
+void indexClique(CpmState* state, int c) {
+    int* vertices = cliqueVertices(&state->cliques, c);
+    for (int j = 0; j < cliqueSize(&state->cliques, c); ++j) {
+        int v = vertices[j];
+        if (state->vertex_clique_count[v] >= state->vertex_clique_capacity[v]) {
+            int capacity = state->vertex_clique_capacity[v] > 0 ? 2 * state->vertex_clique_capacity[v] : 4;
+            state->vertex_cliques[v] = (int*)realloc(state->vertex_cliques[v], capacity * sizeof(int));
+            if (!state->vertex_cliques[v]) {
+                fprintf(stderr, "Memory allocation failed for clique index\n");
+                exit(1);
+            }
+            state->vertex_clique_capacity[v] = capacity;
+        }
+        state->vertex_cliques[v][state->vertex_clique_count[v]++] = c;
+    }
+}
+
+void unindexClique(CpmState* state, int c) {
+    int* vertices = cliqueVertices(&state->cliques, c);
+    for (int j = 0; j < cliqueSize(&state->cliques, c); ++j) {
+        int v = vertices[j];
+        for (int e = 0; e < state->vertex_clique_count[v]; ++e) {
+            if (state->vertex_cliques[v][e] == c) {
+                state->vertex_cliques[v][e] = state->vertex_cliques[v][--state->vertex_clique_count[v]];
+                break;
+            }
+        }
+    }
+}
+
+// Unions clique c with every live clique sharing at least k - 1 vertices with it
+void percolateClique(CpmState* state, int c) {
+    int touched_count = 0;
+    int* vertices = cliqueVertices(&state->cliques, c);
+    for (int j = 0; j < cliqueSize(&state->cliques, c); ++j) {
+        int v = vertices[j];
+        for (int e = 0; e < state->vertex_clique_count[v]; ++e) {
+            int d = state->vertex_cliques[v][e];
+            if (d != c) {
+                if (state->overlap[d] == 0) {
+                    state->touched[touched_count++] = d;
+                }
+                state->overlap[d]++;
+            }
+        }
+    }
+    for (int t = 0; t < touched_count; ++t) {
+        int d = state->touched[t];
+        if (state->overlap[d] >= state->k - 1) {
+            unionSets(state->parent, c, d);
+        }
+        state->overlap[d] = 0;
+    }
+}
+
+// Registers the cliques appended to the pool since index first and merges their communities
+void absorbNewCliques(CpmState* state, int first) {
+    ensureCpmCapacity(state);
+    for (int c = first; c < state->cliques.count; ++c) {
+        state->alive[c] = 1;
+        state->parent[c] = c;
+        indexClique(state, c);
+        percolateClique(state, c);
+    }
+}
+
+#define CPM_CHECKPOINT_MAGIC "CPMCKPT1"
+
+// Layout: magic, k, V, E, next root vertex, clique count, offsets[count + 1],
+// vertices[offsets[count]], alive[count], parent[count]. The vertex-to-clique index is
+// rebuilt from the cliques on resume.
+void saveCpmCheckpoint(const char* path, CpmState* state, Graph* graph, int next_root) {
+    CheckpointWriter writer;
+    if (!beginCheckpoint(&writer, path, CPM_CHECKPOINT_MAGIC)) {
+        return;
+    }
+    CliquePool* cliques = &state->cliques;
+    writeCheckpoint(&writer, &state->k, sizeof(int), 1);
+    writeCheckpoint(&writer, &state->V, sizeof(int), 1);
+    writeCheckpoint(&writer, &graph->E, sizeof(long long), 1);
+    writeCheckpoint(&writer, &next_root, sizeof(int), 1);
+    writeCheckpoint(&writer, &cliques->count, sizeof(int), 1);
+    writeCheckpoint(&writer, cliques->offsets, sizeof(long long), (size_t)cliques->count + 1);
+    writeCheckpoint(&writer, cliques->vertices, sizeof(int), cliques->offsets[cliques->count]);
+    writeCheckpoint(&writer, state->alive, sizeof(unsigned char), cliques->count);
+    writeCheckpoint(&writer, state->parent, sizeof(int), cliques->count);
+    commitCheckpoint(&writer);
+}
+
+// Restores a freshly created, empty state from path and returns the next root vertex to
+// search, or 0 when path holds no usable checkpoint of this graph and k
+int loadCpmCheckpoint(const char* path, CpmState* state, Graph* graph) {
+    FILE* file = openCheckpoint(path, CPM_CHECKPOINT_MAGIC);
+    if (!file) {
+        return 0;
+    }
+    int k, V, next_root, count;
+    long long E;
+    int ok = readCheckpoint(file, &k, sizeof(int), 1) && readCheckpoint(file, &V, sizeof(int), 1) &&
+             readCheckpoint(file, &E, sizeof(long long), 1) && readCheckpoint(file, &next_root, sizeof(int), 1) &&
+             readCheckpoint(file, &count, sizeof(int), 1);
+    if (!ok || k != state->k || V != state->V || E != graph->E || next_root < 0 || next_root > V || count < 0 ||
+        count == INT_MAX) {
+        fprintf(stderr, "Checkpoint %s belongs to another graph or k; starting over\n", path);
+        fclose(file);
+        return 0;
+    }
+
+    // Offsets and vertices are validated before they replace the pool, so a corrupt file
+    // can neither overflow it nor make it allocate far beyond the file's size
+    long long* offsets = NULL;
+    int* vertices = NULL;
+    ok = readCheckpointArray(file, (void**)&offsets, sizeof(long long), (long long)count + 1, "clique offsets") &&
+         offsets[0] == 0;
+    for (int c = 0; ok && c < count; ++c) {
+        long long size = offsets[c + 1] - offsets[c];
+        ok = size >= k && size <= V;
+    }
+    if (ok) {
+        ok = readCheckpointArray(file, (void**)&vertices, sizeof(int), offsets[count], "clique vertices");
+    }
+    for (long long i = 0; ok && i < offsets[count]; ++i) {
+        ok = vertices[i] >= 0 && vertices[i] < V;
+    }
+
+    CliquePool* cliques = &state->cliques;
+    if (ok) {
+        // One spare slot each, so the pool's capacities stay positive when count is 0
+        long long vertex_count = offsets[count];
+        freeCliquePool(cliques);
+        cliques->offsets = (long long*)reallocArray(offsets, (size_t)count + 2, sizeof(long long), "clique offsets");
+        cliques->vertices = (int*)reallocArray(vertices, (size_t)vertex_count + 1, sizeof(int), "clique vertices");
+        cliques->clique_capacity = count + 1;
+        cliques->vertex_capacity = vertex_count + 1;
+        cliques->count = count;
+        ensureCpmCapacity(state);
+        ok = readCheckpoint(file, state->alive, sizeof(unsigned char), count) &&
+             readCheckpoint(file, state->parent, sizeof(int), count);
+        // unionSets links to the smaller root and findSet only halves paths, so every
+        // parent is at most its clique; this also rules out cycles that would hang findSet
+        for (int c = 0; ok && c < count; ++c) {
+            ok = state->alive[c] <= 1 && state->parent[c] >= 0 && state->parent[c] <= c;
+        }
+    } else {
+        free(offsets);
+        free(vertices);
+    }
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Checkpoint %s is truncated or corrupt; starting over\n", path);
+        freeCliquePool(cliques);
+        initCliquePool(cliques, V, (long long)V * k);
+        return 0;
+    }
+
+    state->dead_count = 0;
+    for (int c = 0; c < count; ++c) {
+        if (state->alive[c]) {
+            indexClique(state, c);
+        } else {
+            state->dead_count++;
+        }
+    }
+    return next_root;
+}
+
+CpmState* createCpmState(Graph* graph, int k) {
+    return createCpmStateCheckpointed(graph, k, NULL, 0);
+}
+
+CpmState* createCpmStateCheckpointed(Graph* graph, int k, const char* checkpoint_path, int checkpoint_interval) {
+    printf("Building CPM state for k = %d...\n", k);
+    int V = graph->V;
+    CpmState* state = (CpmState*)calloc(1, sizeof(CpmState));
+    if (!state) {
+        fprintf(stderr, "Memory allocation failed for CPM state\n");
+        exit(1);
+    }
+    state->k = k;
+    state->V = V;
+    initCliquePool(&state->cliques, V, (long long)V * k);
+    state->vertex_cliques = (int**)calloc(V, sizeof(int*));
+    state->vertex_clique_count = (int*)calloc(V, sizeof(int));
+    state->vertex_clique_capacity = (int*)calloc(V, sizeof(int));
+
+    int* R = (int*)malloc(V * sizeof(int));
+    int* P = (int*)malloc(V * sizeof(int));
+    int* X = (int*)malloc(V * sizeof(int));
+    unsigned char* mark = (unsigned char*)calloc(V, sizeof(unsigned char));
+    if (!state->vertex_cliques || !state->vertex_clique_count || !state->vertex_clique_capacity ||
+        !R || !P || !X || !mark) {
+        fprintf(stderr, "Memory allocation failed for CPM state\n");
+        exit(1);
+    }
+    if (checkpoint_interval < 1) {
+        checkpoint_interval = 1;
+    }
+
+    int first_root = 0;
+    if (checkpoint_path) {
+        first_root = loadCpmCheckpoint(checkpoint_path, state, graph);
+        if (first_root > 0) {
+            printf("Resumed from checkpoint %s at root vertex %d with %d cliques.\n",
+                   checkpoint_path, first_root, state->cliques.count);
+        }
+    }
+
+    // Cliques are percolated as soon as their root vertex has been searched
+    for (int v = first_root; v < V; v++) {
+        int first = state->cliques.count;
+        findCliquesFromRoot(graph, v, R, P, X, mark, k, &state->cliques);
+        absorbNewCliques(state, first);
+
+        if (checkpoint_path && ((v + 1) % checkpoint_interval == 0 || v + 1 == V)) {
+            saveCpmCheckpoint(checkpoint_path, state, graph, v + 1);
+        }
+    }
+
+    free(R);
+    free(P);
+    free(X);
+    free(mark);
+    printf("CPM state built with %d cliques.\n", state->cliques.count);
+    return state;
+}
+
+void freeCpmState(CpmState* state) {
+    for (int v = 0; v < state->V; ++v) {
+        free(state->vertex_cliques[v]);
+    }
+    free(state->vertex_cliques);
+    free(state->vertex_clique_count);
+    free(state->vertex_clique_capacity);
+    free(state->alive);
+    free(state->parent);
+    free(state->overlap);
+    free(state->touched);
+    freeCliquePool(&state->cliques);
+    free(state);
+}
+
+// Kills clique c and drops it from the vertex index. Its union-find entry stays, since
+// live cliques may still reach their root through it.
+void retireClique(CpmState* state, int c) {
+    state->alive[c] = 0;
+    state->dead_count++;
+    unindexClique(state, c);
+}
+
+// Retires the older live cliques through u or v that one of the new cliques from index
+// first on contains. A contained clique adds nothing to the communities: every clique
+// overlapping it in k - 1 vertices also overlaps its container, which is already in the
+// same community. mark must be all zero and is left all zero.
+void retireSubsumedCliques(CpmState* state, int first, int u, int v, unsigned char* mark) {
+    CliquePool* cliques = &state->cliques;
+    for (int n = first; n < cliques->count; ++n) {
+        int size = cliqueSize(cliques, n);
+        int* vertices = cliqueVertices(cliques, n);
+        for (int j = 0; j < size; ++j) {
+            mark[vertices[j]] = 1;
+        }
+        for (int side = 0; side < 2; ++side) {
+            int endpoint = side == 0 ? u : v;
+            // Backwards, because retiring moves the last entry into the freed slot
+            for (int e = state->vertex_clique_count[endpoint] - 1; e >= 0; --e) {
+                int c = state->vertex_cliques[endpoint][e];
+                if (c >= first || cliqueSize(cliques, c) > size) {
+                    continue;
+                }
+                int* members = cliqueVertices(cliques, c);
+                int contained = 1;
+                for (int j = 0; j < cliqueSize(cliques, c) && contained; ++j) {
+                    contained = mark[members[j]];
+                }
+                if (contained) {
+                    retireClique(state, c);
+                }
+            }
+        }
+        for (int j = 0; j < size; ++j) {
+            mark[vertices[j]] = 0;
+        }
+    }
+}
+
+// Rebuilds the pool without its dead cliques. Live cliques keep their relative order, so
+// community numbering is unchanged; each community's union-find tree is rebuilt as a star
+// around its first live clique, and the vertex index is rebuilt from scratch.
+void compactCpmState(CpmState* state) {
+    CliquePool* cliques = &state->cliques;
+    int count = cliques->count;
+    int* root = (int*)mallocArray(count, sizeof(int), "CPM compaction");
+    int* representative = (int*)mallocArray(count, sizeof(int), "CPM compaction");
+    long long live_vertices = 0;
+    for (int c = 0; c < count; ++c) {
+        representative[c] = -1;
+        if (state->alive[c]) {
+            root[c] = findSet(state->parent, c);
+            live_vertices += cliqueSize(cliques, c);
+        }
+    }
+
+    CliquePool compacted;
+    initCliquePool(&compacted, count - state->dead_count, live_vertices);
+    for (int c = 0; c < count; ++c) {
+        if (!state->alive[c]) {
+            continue;
+        }
+        int index = compacted.count;
+        addClique(&compacted, cliqueVertices(cliques, c), cliqueSize(cliques, c));
+        if (representative[root[c]] < 0) {
+            representative[root[c]] = index;
+        }
+        state->parent[index] = representative[root[c]];
+    }
+    printf("Compacted the CPM state from %d to %d cliques.\n", count, compacted.count);
+    freeCliquePool(cliques);
+    *cliques = compacted;
+    memset(state->alive, 1, cliques->count);
+    state->dead_count = 0;
+
+    for (int v = 0; v < state->V; ++v) {
+        state->vertex_clique_count[v] = 0;
+    }
+    for (int c = 0; c < cliques->count; ++c) {
+        indexClique(state, c);
+    }
+    free(root);
+    free(representative);
+}
+
+// The new k-cliques all contain u and v, so they are the maximal cliques of the common
+// neighborhood of u and v extended by the edge itself
+void insertCpmEdge(CpmState* state, Graph* graph, int u, int v, int* R, int* P, int* X, unsigned char* mark) {
+    if (u == v || isNeighbor(graph, u, v)) {
+        return;
+    }
+    addEdge(graph, u, v);
+
+    int p_size = 0;
+    markNeighbors(graph, u, mark, 1);
+    NeighborIterator it;
+    int w;
+    for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &w);) {
+        if (w != u && w != v && mark[w] == 1) {
+            P[p_size++] = w;
+            mark[w] = 2; // Skip duplicate edges
+        }
+    }
+    markNeighbors(graph, u, mark, 0);
+
+    R[0] = u;
+    R[1] = v;
+    int first = state->cliques.count;
+    BronKerboschPivot(graph, R, 2, P, p_size, X, 0, mark, state->k, &state->cliques);
+    absorbNewCliques(state, first);
+    retireSubsumedCliques(state, first, u, v, mark);
+}
+
+// Returns 1 if a live clique holds all size vertices of R. mark must be all zero and is
+// left all zero.
+int containedInLiveClique(CpmState* state, const int* R, int size, unsigned char* mark) {
+    for (int j = 0; j < size; ++j) {
+        mark[R[j]] = 1;
+    }
+    int contained = 0;
+    for (int e = 0; e < state->vertex_clique_count[R[0]] && !contained; ++e) {
+        int c = state->vertex_cliques[R[0]][e];
+        int* vertices = cliqueVertices(&state->cliques, c);
+        int hits = 0;
+        for (int j = 0; j < cliqueSize(&state->cliques, c); ++j) {
+            hits += mark[vertices[j]];
+        }
+        contained = hits == size;
+    }
+    for (int j = 0; j < size; ++j) {
+        mark[R[j]] = 0;
+    }
+    return contained;
+}
+
+// Every clique containing both u and v is replaced by its two halves without u and
+// without v, unless a live clique already contains the half. Communities that held such a clique may split, so their cliques are
+// re-percolated from scratch; no other community can be affected.
+void deleteCpmEdge(CpmState* state, Graph* graph, int u, int v, int* R, unsigned char* mark) {
+    if (!removeEdge(graph, u, v)) {
+        fprintf(stderr, "Skipping deletion of missing edge %d -> %d\n", u, v);
+        return;
+    }
+
+    int broken_count = 0;
+    int* broken = (int*)malloc((state->vertex_clique_count[u] + 1) * sizeof(int));
+    if (!broken) {
+        fprintf(stderr, "Memory allocation failed for CPM update\n");
+        exit(1);
+    }
+    for (int e = 0; e < state->vertex_clique_count[u]; ++e) {
+        int c = state->vertex_cliques[u][e];
+        int* vertices = cliqueVertices(&state->cliques, c);
+        for (int j = 0; j < cliqueSize(&state->cliques, c); ++j) {
+            if (vertices[j] == v) {
+                broken[broken_count++] = c;
+                break;
+            }
+        }
+    }
+    if (broken_count == 0) {
+        free(broken);
+        return; // No k-clique used the edge
+    }
+
+    // The affected communities are those of the broken cliques. Each of their cliques is
+    // linked to a broken one through cliques sharing vertices, so they are found by walking
+    // the vertex index outwards instead of scanning the pool. overlap marks the cliques seen
+    // and mark the vertices whose index entries were walked; both are cleared afterwards.
+    int root_count = 0;
+    int* roots = (int*)mallocArray(broken_count, sizeof(int), "CPM update");
+    for (int b = 0; b < broken_count; ++b) {
+        int root = findSet(state->parent, broken[b]);
+        int known = 0;
+        for (int r = 0; r < root_count && !known; ++r) {
+            known = roots[r] == root;
+        }
+        if (!known) {
+            roots[root_count++] = root;
+        }
+    }
+    int member_capacity = 2 * broken_count + 16;
+    int member_count = 0;
+    int* members = (int*)mallocArray(member_capacity, sizeof(int), "CPM update");
+    for (int b = 0; b < broken_count; ++b) {
+        state->overlap[broken[b]] = 1;
+        members[member_count++] = broken[b];
+    }
+    for (int m = 0; m < member_count; ++m) {
+        int* vertices = cliqueVertices(&state->cliques, members[m]);
+        for (int j = 0; j < cliqueSize(&state->cliques, members[m]); ++j) {
+            int w = vertices[j];
+            if (mark[w]) {
+                continue;
+            }
+            mark[w] = 1;
+            for (int e = 0; e < state->vertex_clique_count[w]; ++e) {
+                int d = state->vertex_cliques[w][e];
+                if (state->overlap[d]) {
+                    continue;
+                }
+                int root = findSet(state->parent, d);
+                int affected = 0;
+                for (int r = 0; r < root_count && !affected; ++r) {
+                    affected = roots[r] == root;
+                }
+                if (affected) {
+                    if (member_count >= member_capacity) {
+                        member_capacity *= 2;
+                        members = (int*)reallocArray(members, member_capacity, sizeof(int), "CPM update");
+                    }
+                    state->overlap[d] = 1;
+                    members[member_count++] = d;
+                }
+            }
+        }
+    }
+    for (int m = 0; m < member_count; ++m) {
+        int* vertices = cliqueVertices(&state->cliques, members[m]);
+        for (int j = 0; j < cliqueSize(&state->cliques, members[m]); ++j) {
+            mark[vertices[j]] = 0;
+        }
+        state->overlap[members[m]] = 0;
+    }
+
+    for (int b = 0; b < broken_count; ++b) {
+        retireClique(state, broken[b]);
+    }
+    // A half that a live clique contains would only repeat that clique's overlaps, and
+    // such a container shares k vertices with the broken clique, so it is re-percolated
+    // with the members anyway. Halves are indexed as they are added to catch duplicates.
+    int old_count = state->cliques.count;
+    for (int b = 0; b < broken_count; ++b) {
+        int c = broken[b];
+        int size = cliqueSize(&state->cliques, c);
+        if (size - 1 < state->k) {
+            continue;
+        }
+        for (int drop = 0; drop < 2; ++drop) {
+            int removed = drop == 0 ? u : v;
+            int r_size = 0;
+            int* vertices = cliqueVertices(&state->cliques, c); // The pool may move between halves
+            for (int j = 0; j < size; ++j) {
+                if (vertices[j] != removed) {
+                    R[r_size++] = vertices[j];
+                }
+            }
+            if (!containedInLiveClique(state, R, r_size, mark)) {
+                addClique(&state->cliques, R, r_size);
+                indexClique(state, state->cliques.count - 1);
+            }
+        }
+    }
+    ensureCpmCapacity(state);
+
+    int new_count = state->cliques.count - old_count;
+    if (member_count + new_count > member_capacity) {
+        member_capacity = member_count + new_count;
+        members = (int*)reallocArray(members, member_capacity, sizeof(int), "CPM update");
+    }
+    for (int c = old_count; c < state->cliques.count; ++c) {
+        state->alive[c] = 1;
+        members[member_count++] = c;
+    }
+
+    for (int m = 0; m < member_count; ++m) {
+        state->parent[members[m]] = members[m];
+    }
+    for (int m = 0; m < member_count; ++m) {
+        if (state->alive[members[m]]) {
+            percolateClique(state, members[m]);
+        }
+    }
+
+    free(members);
+    free(roots);
+    free(broken);
+}
+
+void updateCpmState(CpmState* state, Graph* graph, const EdgeUpdate* updates, int update_count) {
+    int V = state->V;
+    int* R = (int*)malloc(V * sizeof(int));
+    int* P = (int*)malloc(V * sizeof(int));
+    int* X = (int*)malloc(V * sizeof(int));
+    unsigned char* mark = (unsigned char*)calloc(V, sizeof(unsigned char));
+    if (!R || !P || !X || !mark) {
+        fprintf(stderr, "Memory allocation failed for CPM update\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < update_count; ++i) {
+        int src = updates[i].src;
+        int dest = updates[i].dest;
+        if (updates[i].insert) {
+            insertCpmEdge(state, graph, src, dest, R, P, X, mark);
+        } else {
+            deleteCpmEdge(state, graph, src, dest, R, mark);
+        }
+        if (state->dead_count > state->cliques.count / 2) {
+            compactCpmState(state);
+        }
+    }
+
+    free(R);
+    free(P);
+    free(X);
+    free(mark);
+}
+
+// Finds the live clique of the state with exactly the vertices of found clique f; its
+// smallest vertex is root. mark must be all zero and is left all zero.
+int findLiveClique(CpmState* state, const CliquePool* found, int f, int root, unsigned char* mark) {
+    int size = cliqueSize(found, f);
+    int* vertices = cliqueVertices(found, f);
+    for (int j = 0; j < size; ++j) {
+        mark[vertices[j]] = 1;
+    }
+    int match = -1;
+    for (int e = 0; e < state->vertex_clique_count[root] && match < 0; ++e) {
+        int c = state->vertex_cliques[root][e];
+        if (cliqueSize(&state->cliques, c) != size) {
+            continue;
+        }
+        int* members = cliqueVertices(&state->cliques, c);
+        int same = 1;
+        for (int j = 0; j < size && same; ++j) {
+            same = mark[members[j]];
+        }
+        if (same) {
+            match = c;
+        }
+    }
+    for (int j = 0; j < size; ++j) {
+        mark[vertices[j]] = 0;
+    }
+    return match;
+}
+
+// After updates the pool holds cliques in arrival order, plus halves of broken cliques that
+// are no longer maximal, so projecting it directly would label overlapping nodes
+// differently from a rebuild. The root searches are rerun instead, one root at a time, to
+// visit the maximal cliques in the order cliqueCommunity does; only their communities come
+// from the state. Every maximal clique of at least k vertices is live in the state.
+void cpmStateLabels(CpmState* state, Graph* graph, int* labels) {
+    int V = state->V;
+    for (int v = 0; v < V; ++v) {
+        labels[v] = -1;
+    }
+    int* community_id = (int*)mallocArray(state->cliques.count > 0 ? state->cliques.count : 1, sizeof(int),
+                                           "CPM labels");
+    for (int c = 0; c < state->cliques.count; ++c) {
+        community_id[c] = -1;
+    }
+    int* R = (int*)mallocArray(V, sizeof(int), "CPM labels");
+    int* P = (int*)mallocArray(V, sizeof(int), "CPM labels");
+    int* X = (int*)mallocArray(V, sizeof(int), "CPM labels");
+    unsigned char* mark = (unsigned char*)callocArray(V, sizeof(unsigned char), "CPM labels");
+    CliquePool found;
+    initCliquePool(&found, 64, 64 * (long long)state->k);
+
+    int community_count = 0;
+    for (int v = 0; v < V; ++v) {
+        if (state->vertex_clique_count[v] == 0) {
+            continue; // No clique at all through v, so none rooted at it
+        }
+        found.count = 0;
+        findCliquesFromRoot(graph, v, R, P, X, mark, state->k, &found);
+        for (int f = 0; f < found.count; ++f) {
+            int c = findLiveClique(state, &found, f, v, mark);
+            if (c < 0) {
+                fprintf(stderr, "CPM state is missing a maximal clique rooted at %d\n", v);
+                exit(1);
+            }
+            int root = findSet(state->parent, c);
+            if (community_id[root] < 0) {
+                community_id[root] = community_count++;
+            }
+            int* vertices = cliqueVertices(&found, f);
+            for (int j = 0; j < cliqueSize(&found, f); ++j) {
+                labels[vertices[j]] = community_id[root];
+            }
+        }
+    }
+
+    freeCliquePool(&found);
+    free(R);
+    free(P);
+    free(X);
+    free(mark);
+    free(community_id);
+}
@@ -0,0 +1,86 @@
+#ifndef CLIQUE_PERCOLATION_H
+#define CLIQUE_PERCOLATION_H
+
+#include <stdbool.h>
+#include "graph.h"
+
+// All cliques live in one arena: their vertices are stored back to back in a single
+// buffer and clique i occupies vertices[offsets[i]] .. vertices[offsets[i + 1] - 1].
+typedef struct {
+    int* vertices;
+    long long* offsets;         // 64-bit: the pool may hold more than 2^31 clique vertices
+    int count;
+    long long vertex_capacity;
+    int clique_capacity;
+} CliquePool;
+
+static inline int cliqueSize(const CliquePool* pool, int i) {
+    return (int)(pool->offsets[i + 1] - pool->offsets[i]);
+}
+
+static inline int* cliqueVertices(const CliquePool* pool, int i) {
+    return pool->vertices + pool->offsets[i];
+}
+
+void initCliquePool(CliquePool* pool, int clique_capacity, long long vertex_capacity);
+void freeCliquePool(CliquePool* pool);
+void addClique(CliquePool* pool, const int* R, int size);
+
+bool isNeighbor(Graph* graph, int u, int v);
+void findTriangles(Graph* graph, int* labels, CliquePool* cliques);
+void findCliques(Graph* graph, int k, int* labels, CliquePool* cliques);
+// Appends the maximal cliques of at least k vertices whose smallest vertex is v. R, P and X
+// hold V vertices and mark must be all zero; it is left all zero.
+void findCliquesFromRoot(Graph* graph, int v, int* R, int* P, int* X, unsigned char* mark, int k, CliquePool* cliques);
+int countSharedVertices(const CliquePool* cliques, int i, int j);
+Graph* buildCliqueGraph(CliquePool* cliques, int k, int directed);
+void decomposeGraph(Graph* graph, int* component, int* component_count);
+void mapCliquesToNodes(int* labels, CliquePool* cliques, int* component_labels);
+void cliqueCommunity(Graph* graph, int k, int* labels, int directed);
+void cliqueCommunitySweep(Graph* graph, int k_min, int k_max, int** labels_per_k);
+
+int findSet(int* parent, int x);
+void unionSets(int* parent, int a, int b);
+
+// Persistent CPM state for an undirected graph that changes over time. It stores cliques of
+// at least k vertices (maximal when found; an insertion retires the older cliques through
+// its endpoints that a new clique contains), an index from each vertex to the live cliques
+// containing it, and a union-find over cliques sharing at least k - 1 vertices. Dead
+// cliques are compacted out of the pool once they make up more than half of it.
+typedef struct CpmState {
+    int k;
+    int V;
+    CliquePool cliques;
+    unsigned char* alive;       // 0 for cliques destroyed by a deletion or subsumed
+    int dead_count;             // Cliques in the pool with alive == 0
+    int* parent;                // Union-find forest over cliques
+    int* overlap;               // Scratch overlap counters, all zero between calls
+    int* touched;               // Scratch list of cliques with a non-zero overlap
+    int capacity;               // Allocated length of alive, parent, overlap and touched
+    int** vertex_cliques;       // Live cliques containing each vertex
+    int* vertex_clique_count;
+    int* vertex_clique_capacity;
+} CpmState;
+
+CpmState* createCpmState(Graph* graph, int k);
+
+// createCpmState that checkpoints the cliques found so far, the union-find and the next
+// root vertex to checkpoint_path every checkpoint_interval root vertices and at the end.
+// An existing checkpoint of the same graph and k is resumed, giving the same state as
+// an uninterrupted build.
+CpmState* createCpmStateCheckpointed(Graph* graph, int k, const char* checkpoint_path, int checkpoint_interval);
+void freeCpmState(CpmState* state);
+
+// Applies a batch of edge insertions and deletions to the graph and the CPM state.
+// Insertions only enumerate the new cliques through both endpoints; deletions only
+// re-percolate the communities that contained the deleted edge. Update endpoints must lie
+// in [0, V), as readEdgeUpdates guarantees.
+void updateCpmState(CpmState* state, Graph* graph, const EdgeUpdate* updates, int update_count);
+
+// Writes the node labels cliqueCommunity would give the graph in its current state:
+// communities are numbered in order of their first maximal clique in root-search order,
+// a node in several communities takes that of its last clique, and nodes outside every
+// clique get -1. Reruns the root searches but not the clique overlaps.
+void cpmStateLabels(CpmState* state, Graph* graph, int* labels);
+
+#endif // CLIQUE_PERCOLATION_H
@@ -0,0 +1,189 @@
+// communityLib.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "communityLib.h"
+
+CommunityGraph* loadCommunityGraph(const char* filename, int V, int directed, int compressed) {
+    Graph* graph = createGraphFromFile(filename, V, directed);
+    if (compressed) {
+        compressGraph(graph);
+    }
+    return createCommunityGraph(graph);
+}
+
+CommunityGraph* createCommunityGraph(Graph* graph) {
+    CommunityGraph* handle = (CommunityGraph*)callocArray(1, sizeof(CommunityGraph), "community graph");
+    handle->graph = graph;
+    return handle;
+}
+
+void freeCommunityGraph(CommunityGraph* handle) {
+    free(handle->node_order);
+    free(handle->neighbor_labels);
+    free(handle->scratch);
+    if (handle->node_order) {
+        freeLpaSweep(&handle->sweep);
+    }
+    free(handle->R);
+    free(handle->P);
+    free(handle->X);
+    free(handle->mark);
+    if (handle->cpm_ready) {
+        freeCliquePool(&handle->cliques);
+    }
+    if (handle->metrics_ready) {
+        freeMetricsWorkspace(&handle->metrics);
+    }
+    freeGraph(handle->graph);
+    free(handle);
+}
+
+void defaultLpaOptions(LpaOptions* options) {
+    options->seed = 3000;
+    options->max_iterations = MAX_ITER;
+    options->direction = LPA_OUT_EDGES;
+}
+
+int runLPA(CommunityGraph* handle, const LpaOptions* options, int* labels) {
+    Graph* graph = handle->graph;
+    int V = graph->V;
+    if (!handle->node_order) {
+        handle->node_order = (int*)mallocArray(V, sizeof(int), "node order");
+        handle->findMode = selectModeKernel();
+        initLpaSweep(&handle->sweep, V);
+    }
+    // Voting along both directions can need more room than the first call did
+    int vote_degree = maxVotingDegree(graph, options->direction) + 1;
+    if (vote_degree > handle->vote_capacity) {
+        handle->vote_capacity = vote_degree;
+        handle->neighbor_labels = (int*)reallocArray(handle->neighbor_labels, vote_degree, sizeof(int), "neighbor labels");
+        handle->scratch = (int*)reallocArray(handle->scratch, vote_degree, sizeof(int), "vote scratch");
+    }
+    beginLpaSweeps(&handle->sweep, graph, options->direction);
+    int max_iterations = options->max_iterations;
+    if (max_iterations < 1 || max_iterations > MAX_ITER) {
+        max_iterations = MAX_ITER;
+    }
+
+    for (int i = 0; i < V; ++i) {
+        handle->node_order[i] = i;
+        labels[i] = i;
+    }
+    unsigned int rng;
+    seedRandom(&rng, options->seed);
+
+    int loop_count = 0;
+    int changed = 1;
+    while (changed && loop_count < max_iterations) {
+        loop_count++;
+        shuffleWithState(handle->node_order, V, &rng);
+        changed = relabelSweep(graph, labels, handle->node_order, handle->neighbor_labels, handle->scratch,
+                               handle->findMode, &handle->sweep);
+    }
+    return loop_count;
+}
+
+int runCPM(CommunityGraph* handle, int k, int* labels) {
+    Graph* graph = handle->graph;
+    int V = graph->V;
+    if (!handle->cpm_ready) {
+        handle->R = (int*)mallocArray(V, sizeof(int), "clique search");
+        handle->P = (int*)mallocArray(V, sizeof(int), "clique search");
+        handle->X = (int*)mallocArray(V, sizeof(int), "clique search");
+        handle->mark = (unsigned char*)callocArray(V, sizeof(unsigned char), "clique search");
+        initCliquePool(&handle->cliques, V, V); // Grows with the cliques actually found
+        handle->cpm_ready = 1;
+    }
+
+    // The pool keeps its capacity between calls; only its contents are discarded
+    CliquePool* cliques = &handle->cliques;
+    cliques->count = 0;
+    for (int v = 0; v < V; v++) {
+        findCliquesFromRoot(graph, v, handle->R, handle->P, handle->X, handle->mark, k, cliques);
+    }
+
+    Graph* clique_graph = buildCliqueGraph(cliques, k, graph->directed);
+    int* component = (int*)mallocArray(cliques->count, sizeof(int), "clique components");
+    int component_count = 0;
+    decomposeGraph(clique_graph, component, &component_count);
+
+    for (int v = 0; v < V; ++v) {
+        labels[v] = -1;
+    }
+    mapCliquesToNodes(labels, cliques, component);
+
+    free(component);
+    freeGraph(clique_graph);
+    return component_count;
+}
+
+CommunityMetrics evaluateCommunities(CommunityGraph* handle, int* labels) {
+    Graph* graph = handle->graph;
+    int V = graph->V;
+    if (!handle->metrics_ready) {
+        initMetricsWorkspace(&handle->metrics, V);
+        handle->metrics_ready = 1;
+    }
+
+    CommunityMetrics metrics;
+    metrics.community_count = countCommunities(labels, V);
+    metrics.modularity = modularityWithWorkspace(graph, labels, V, graph->E, graph->directed, &handle->metrics);
+    metrics.conductance = conductanceWithWorkspace(graph, labels, V, graph->directed, &handle->metrics);
+    metrics.coverage = calculateCoverage(graph, labels, V, graph->E, graph->directed);
+    return metrics;
+}
+
+int countCommunities(const int* labels, int V) {
+    // Labels of every algorithm here lie in [-1, V)
+    unsigned char* seen = (unsigned char*)callocArray(V, sizeof(unsigned char), "community marks");
+    int count = 0;
+    for (int i = 0; i < V; ++i) {
+        if (labels[i] >= 0 && !seen[labels[i]]) {
+            seen[labels[i]] = 1;
+            count++;
+        }
+    }
+    free(seen);
+    return count;
+}
+
+void printCommunities(const int* labels, int V) {
+    int max_label = -1;
+    for (int i = 0; i < V; ++i) {
+        if (labels[i] > max_label) {
+            max_label = labels[i];
+        }
+    }
+    if (max_label == -1) {
+        printf("No communities found.\n");
+        return;
+    }
+
+    // Nodes labelled -1 belong to no community
+    int* community_count = (int*)callocArray((size_t)max_label + 1, sizeof(int), "community sizes");
+    for (int i = 0; i < V; ++i) {
+        if (labels[i] >= 0) {
+            community_count[labels[i]]++;
+        }
+    }
+
+    int num_communities = 0;
+    for (int i = 0; i <= max_label; ++i) {
+        if (community_count[i] > 0) {
+            num_communities++;
+        }
+    }
+
+    printf("\nNumber of Communities: %d\n", num_communities);
+
+    int counter = 1;
+    for (int i = 0; i <= max_label; ++i) {
+        if (community_count[i] > 0) {
+            printf("Community %d: %d nodes\n", counter++, community_count[i]);
+        }
+    }
+    printf("\n");
+
+    free(community_count);
+}
@@ -0,0 +1,71 @@
+#ifndef COMMUNITY_LIB_H
+#define COMMUNITY_LIB_H
+
+#include "graph.h"
+#include "cliquePercolation.h"
+#include "labelPropagation.h"
+#include "performanceMeasure.h"
+
+// Load-once, run-many interface to the community detection modules. A CommunityGraph owns
+// one in-memory graph plus the scratch buffers its algorithms need; each workspace is
+// allocated on first use and reused by every later call, so parameter sweeps pay for
+// loading and V-sized allocations once. The graph must not change while the handle holds it.
+typedef struct {
+    Graph* graph;
+
+    // LPA workspace
+    int* node_order;
+    int* neighbor_labels;
+    int* scratch;
+    int vote_capacity;
+    ModeKernel findMode;
+    LpaSweep sweep;
+
+    // CPM workspace
+    int* R;
+    int* P;
+    int* X;
+    unsigned char* mark;
+    CliquePool cliques;
+    int cpm_ready;
+
+    int metrics_ready;
+    MetricsWorkspace metrics;
+} CommunityGraph;
+
+typedef struct {
+    unsigned int seed;      // Seed of the node order generator; equal seeds give equal labels
+    int max_iterations;     // Capped at MAX_ITER
+    LpaDirection direction; // In-edge directions need buildReverseIndex on a directed graph
+} LpaOptions;
+
+typedef struct {
+    int community_count;
+    double modularity;
+    double conductance;
+    double coverage;
+} CommunityMetrics;
+
+CommunityGraph* loadCommunityGraph(const char* filename, int V, int directed, int compressed);
+// Takes ownership of graph; freeCommunityGraph frees it
+CommunityGraph* createCommunityGraph(Graph* graph);
+void freeCommunityGraph(CommunityGraph* handle);
+
+void defaultLpaOptions(LpaOptions* options);
+
+// Label propagation from singleton labels. Node order comes from a per-call generator
+// rather than rand(), so calls are independent of each other and of labelPropagation's
+// seeding. Returns the number of iterations.
+int runLPA(CommunityGraph* handle, const LpaOptions* options, int* labels);
+
+// Clique percolation communities for clique size k, labelled as cliqueCommunity does
+// (-1 for nodes outside every k-clique). Returns the number of communities.
+int runCPM(CommunityGraph* handle, int k, int* labels);
+
+CommunityMetrics evaluateCommunities(CommunityGraph* handle, int* labels);
+
+// Communities are the distinct non-negative labels
+int countCommunities(const int* labels, int V);
+void printCommunities(const int* labels, int V);
+
+#endif // COMMUNITY_LIB_H
@@ -0,0 +1,466 @@
+// communityServer.c
+// Keeps one graph and its communities resident and answers queries over a Unix domain
+// socket, one request per line:
+//     COMMUNITY v      -> OK <community of v, -1 if none>
+//     SIZE v           -> OK <number of nodes in the community of v>
+//     MEMBERS v        -> OK <count> <node> <node> ...
+//     NEIGHBORS v      -> OK <count> <community>:<neighbors of v in it> ...
+//     RECOMPUTE LPA s  -> OK started; reruns LPA with seed s in the background
+//     RECOMPUTE CPM k  -> OK started; reruns CPM with clique size k in the background
+//     STATUS           -> OK version <n> communities <c> computing <0|1> <algorithm>
+//     QUIT             -> closes the connection
+// Failures answer ERR <reason>. Queries keep being served from the previous communities
+// while a recomputation runs; the new ones replace them atomically when it finishes.
+// Try it with: socat - UNIX-CONNECT:/tmp/lpa-communities.sock
+#ifndef _WIN32
+#define _GNU_SOURCE // Read-write locks and sockets are hidden under a strict -std=c11
+#endif
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "graph.h"
+#include "communityLib.h"
+
+#ifdef _WIN32
+
+int main() {
+    printf("The community server needs Unix domain sockets and POSIX threads.\n");
+    return 1;
+}
+
+#else
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Immutable once published: queries read it under the read lock and a recomputation
+// builds a new one before swapping it in
+typedef struct {
+    int version;
+    int community_count;
+    int* community;     // Community of each vertex, 0 .. community_count - 1 or -1
+    int* start;         // Members of community c are members[start[c]] .. members[start[c + 1] - 1]
+    int* members;
+    char algorithm[32];
+} CommunityIndex;
+
+typedef struct {
+    CommunityGraph* handle;
+    CommunityIndex* index;
+    pthread_rwlock_t index_lock;
+    atomic_int computing;          // 1 while the single background recomputation runs
+    int next_version;
+    int* labels;                   // Scratch labels, only touched by the recomputation
+} ServerState;
+
+typedef struct {
+    ServerState* state;
+    int algorithm_cpm;
+    int parameter;
+} RecomputeRequest;
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} Reply;
+
+const char* active_socket_path = NULL;
+
+// Renumbers raw labels by smallest vertex and groups the vertices of each community
+CommunityIndex* buildCommunityIndex(const int* labels, int V, int version, const char* algorithm) {
+    CommunityIndex* index = (CommunityIndex*)mallocArray(1, sizeof(CommunityIndex), "community index");
+    int* remap = (int*)mallocArray(V, sizeof(int), "community index");
+    index->community = (int*)mallocArray(V, sizeof(int), "community index");
+    for (int v = 0; v < V; ++v) {
+        remap[v] = -1;
+    }
+
+    int count = 0;
+    for (int v = 0; v < V; ++v) {
+        int label = labels[v];
+        if (label < 0) {
+            index->community[v] = -1;
+            continue;
+        }
+        if (remap[label] < 0) {
+            remap[label] = count++;
+        }
+        index->community[v] = remap[label];
+    }
+    free(remap);
+
+    index->start = (int*)callocArray((size_t)count + 1, sizeof(int), "community index");
+    index->members = (int*)mallocArray(V, sizeof(int), "community index");
+    for (int v = 0; v < V; ++v) {
+        if (index->community[v] >= 0) {
+            index->start[index->community[v] + 1]++;
+        }
+    }
+    for (int c = 0; c < count; ++c) {
+        index->start[c + 1] += index->start[c];
+    }
+    int* fill = (int*)mallocArray((size_t)count + 1, sizeof(int), "community index");
+    memcpy(fill, index->start, ((size_t)count + 1) * sizeof(int));
+    for (int v = 0; v < V; ++v) {
+        if (index->community[v] >= 0) {
+            index->members[fill[index->community[v]]++] = v;
+        }
+    }
+    free(fill);
+
+    index->version = version;
+    index->community_count = count;
+    snprintf(index->algorithm, sizeof(index->algorithm), "%s", algorithm);
+    return index;
+}
+
+void freeCommunityIndex(CommunityIndex* index) {
+    free(index->community);
+    free(index->start);
+    free(index->members);
+    free(index);
+}
+
+// Runs one algorithm and publishes its communities; the caller has claimed computing
+void computeCommunities(ServerState* state, int algorithm_cpm, int parameter) {
+    int V = state->handle->graph->V;
+    char algorithm[32];
+    clock_t start = clock();
+    if (algorithm_cpm) {
+        runCPM(state->handle, parameter, state->labels);
+        snprintf(algorithm, sizeof(algorithm), "CPM k=%d", parameter);
+    } else {
+        LpaOptions options;
+        defaultLpaOptions(&options);
+        options.seed = (unsigned int)parameter;
+        runLPA(state->handle, &options, state->labels);
+        snprintf(algorithm, sizeof(algorithm), "LPA seed=%d", parameter);
+    }
+    CommunityIndex* index = buildCommunityIndex(state->labels, V, ++state->next_version, algorithm);
+    double cpu_time_used = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+
+    pthread_rwlock_wrlock(&state->index_lock);
+    CommunityIndex* old = state->index;
+    state->index = index;
+    pthread_rwlock_unlock(&state->index_lock);
+    if (old) {
+        freeCommunityIndex(old);
+    }
+    printf("Published version %d (%s): %d communities in %f seconds.\n",
+           index->version, algorithm, index->community_count, cpu_time_used);
+    fflush(stdout);
+}
+
+void* recomputeThread(void* argument) {
+    RecomputeRequest* request = (RecomputeRequest*)argument;
+    ServerState* state = request->state;
+    computeCommunities(state, request->algorithm_cpm, request->parameter);
+    free(request);
+    atomic_store(&state->computing, 0);
+    return NULL;
+}
+
+void appendReply(Reply* reply, const char* format, ...) {
+    while (1) {
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(reply->data + reply->length, reply->capacity - reply->length, format, args);
+        va_end(args);
+        if (written < 0) {
+            return;
+        }
+        if ((size_t)written < reply->capacity - reply->length) {
+            reply->length += written;
+            return;
+        }
+        reply->capacity = 2 * reply->capacity + written;
+        reply->data = (char*)reallocArray(reply->data, reply->capacity, 1, "reply");
+    }
+}
+
+// Parses "<command> <vertex>" and checks the vertex; returns -1 after replying with an error
+int parseVertex(const char* argument, int V, Reply* reply) {
+    char* end;
+    long v = strtol(argument, &end, 10);
+    if (end == argument || v < 0 || v >= V) {
+        appendReply(reply, "ERR vertex must be in [0, %d)\n", V);
+        return -1;
+    }
+    return (int)v;
+}
+
+void answerQuery(ServerState* state, const char* line, Reply* reply, int* counts, int* touched) {
+    Graph* graph = state->handle->graph;
+    int V = graph->V;
+    char command[16];
+    int consumed = 0;
+    if (sscanf(line, "%15s %n", command, &consumed) != 1) {
+        appendReply(reply, "ERR empty request\n");
+        return;
+    }
+    const char* argument = line + consumed;
+
+    if (strcmp(command, "RECOMPUTE") == 0) {
+        char algorithm[8];
+        int parameter;
+        if (sscanf(argument, "%7s %d", algorithm, &parameter) != 2 ||
+            (strcmp(algorithm, "LPA") != 0 && strcmp(algorithm, "CPM") != 0)) {
+            appendReply(reply, "ERR usage: RECOMPUTE LPA <seed> | RECOMPUTE CPM <k>\n");
+            return;
+        }
+        if (strcmp(algorithm, "CPM") == 0 && (parameter < 2 || graph->directed)) {
+            appendReply(reply, "ERR CPM needs an undirected graph and k >= 2\n");
+            return;
+        }
+        if (strcmp(algorithm, "CPM") == 0) {
+            // No clique is larger than the highest degree plus one
+            int max_degree = 0;
+            for (int v = 0; v < V; ++v) {
+                int degree = vertexDegree(graph, v);
+                if (degree > max_degree) {
+                    max_degree = degree;
+                }
+            }
+            if (parameter > max_degree + 1) {
+                appendReply(reply, "ERR k exceeds the largest possible clique (%d)\n", max_degree + 1);
+                return;
+            }
+        }
+        int idle = 0;
+        if (!atomic_compare_exchange_strong(&state->computing, &idle, 1)) {
+            appendReply(reply, "ERR busy\n");
+            return;
+        }
+        RecomputeRequest* request = (RecomputeRequest*)mallocArray(1, sizeof(RecomputeRequest), "recompute request");
+        request->state = state;
+        request->algorithm_cpm = strcmp(algorithm, "CPM") == 0;
+        request->parameter = parameter;
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, recomputeThread, request) != 0) {
+            free(request);
+            atomic_store(&state->computing, 0);
+            appendReply(reply, "ERR could not start recomputation\n");
+            return;
+        }
+        pthread_detach(thread);
+        appendReply(reply, "OK started\n");
+        return;
+    }
+
+    pthread_rwlock_rdlock(&state->index_lock);
+    const CommunityIndex* index = state->index;
+    if (strcmp(command, "STATUS") == 0) {
+        appendReply(reply, "OK version %d communities %d computing %d %s\n",
+                    index->version, index->community_count, atomic_load(&state->computing), index->algorithm);
+    } else if (strcmp(command, "COMMUNITY") == 0) {
+        int v = parseVertex(argument, V, reply);
+        if (v >= 0) {
+            appendReply(reply, "OK %d\n", index->community[v]);
+        }
+    } else if (strcmp(command, "SIZE") == 0) {
+        int v = parseVertex(argument, V, reply);
+        if (v >= 0) {
+            int c = index->community[v];
+            appendReply(reply, "OK %d\n", c >= 0 ? index->start[c + 1] - index->start[c] : 0);
+        }
+    } else if (strcmp(command, "MEMBERS") == 0) {
+        int v = parseVertex(argument, V, reply);
+        if (v >= 0) {
+            int c = index->community[v];
+            int first = c >= 0 ? index->start[c] : 0;
+            int last = c >= 0 ? index->start[c + 1] : 0;
+            appendReply(reply, "OK %d", last - first);
+            for (int m = first; m < last; ++m) {
+                appendReply(reply, " %d", index->members[m]);
+            }
+            appendReply(reply, "\n");
+        }
+    } else if (strcmp(command, "NEIGHBORS") == 0) {
+        int v = parseVertex(argument, V, reply);
+        if (v >= 0) {
+            // counts is indexed by community; touched lists the communities seen around v
+            int touched_count = 0;
+            NeighborIterator it;
+            int dest;
+            for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &dest);) {
+                int c = index->community[dest];
+                if (c >= 0) {
+                    if (counts[c] == 0) {
+                        touched[touched_count++] = c;
+                    }
+                    counts[c]++;
+                }
+            }
+            appendReply(reply, "OK %d", touched_count);
+            for (int t = 0; t < touched_count; ++t) {
+                appendReply(reply, " %d:%d", touched[t], counts[touched[t]]);
+                counts[touched[t]] = 0;
+            }
+            appendReply(reply, "\n");
+        }
+    } else {
+        appendReply(reply, "ERR unknown command %s\n", command);
+    }
+    pthread_rwlock_unlock(&state->index_lock);
+}
+
+int writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written <= 0) {
+            return 0;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return 1;
+}
+
+typedef struct {
+    ServerState* state;
+    int fd;
+} Connection;
+
+void* connectionThread(void* argument) {
+    Connection* connection = (Connection*)argument;
+    ServerState* state = connection->state;
+    int fd = connection->fd;
+    free(connection);
+
+    int V = state->handle->graph->V;
+    int* counts = (int*)callocArray(V, sizeof(int), "neighbor communities");
+    int* touched = (int*)mallocArray(V, sizeof(int), "neighbor communities");
+    Reply reply = { (char*)mallocArray(4096, 1, "reply"), 0, 4096 };
+    char buffer[4096];
+    size_t buffered = 0;
+    int open_connection = 1;
+
+    while (open_connection) {
+        ssize_t received = read(fd, buffer + buffered, sizeof(buffer) - 1 - buffered);
+        if (received <= 0) {
+            break;
+        }
+        buffered += (size_t)received;
+        buffer[buffered] = '\0';
+
+        // Answer every complete line; pipelined requests are answered in one write
+        char* line = buffer;
+        char* newline;
+        reply.length = 0;
+        while ((newline = strchr(line, '\n')) != NULL) {
+            *newline = '\0';
+            if (newline > line && newline[-1] == '\r') {
+                newline[-1] = '\0';
+            }
+            if (strcmp(line, "QUIT") == 0) {
+                open_connection = 0;
+                break;
+            }
+            answerQuery(state, line, &reply, counts, touched);
+            line = newline + 1;
+        }
+        if (reply.length > 0 && !writeAll(fd, reply.data, reply.length)) {
+            break;
+        }
+        buffered -= (size_t)(line - buffer);
+        memmove(buffer, line, buffered);
+        if (buffered == sizeof(buffer) - 1) {
+            writeAll(fd, "ERR request too long\n", 21);
+            break;
+        }
+    }
+
+    close(fd);
+    free(reply.data);
+    free(counts);
+    free(touched);
+    return NULL;
+}
+
+void stopServer(int signal_number) {
+    (void)signal_number;
+    if (active_socket_path) {
+        unlink(active_socket_path);
+    }
+    _exit(0);
+}
+
+int main() {
+    int directed = 0;
+    int V = 4039; // Number of vertices
+
+    //SNAP facebook V=4039 directed=0 seed=3000
+    const char* filename = "C:datasets\\facebook_combined.txt";
+
+    // The snapshot holds the compressed adjacency; it is written on the first start and
+    // mapped directly on later ones, skipping the edge list parsing
+    const char* snapshot_filename = "C:datasets\\facebook_combined.lpasnap";
+    const char* socket_path = "/tmp/lpa-communities.sock";
+
+    // Communities computed at startup: LPA with this seed, or CPM with clique size k
+    int use_cpm = 0;
+    int seed = 3000;
+    int k = 3;
+
+    Graph* graph = loadGraphSnapshot(snapshot_filename);
+    if (!graph) {
+        printf("Reading graph from file: %s\n", filename);
+        graph = createGraphFromFile(filename, V, directed);
+        saveGraphSnapshot(graph, snapshot_filename);
+    }
+
+    ServerState state;
+    memset(&state, 0, sizeof(state));
+    state.handle = createCommunityGraph(graph);
+    state.labels = (int*)mallocArray(graph->V, sizeof(int), "labels");
+    pthread_rwlock_init(&state.index_lock, NULL);
+    atomic_init(&state.computing, 0);
+    computeCommunities(&state, use_cpm, use_cpm ? k : seed);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (listener < 0 || strlen(socket_path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Unable to create socket %s\n", socket_path);
+        exit(1);
+    }
+    strcpy(address.sun_path, socket_path);
+    unlink(socket_path);
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 64) != 0) {
+        fprintf(stderr, "Unable to listen on %s\n", socket_path);
+        exit(1);
+    }
+    active_socket_path = socket_path;
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+    printf("Serving communities on %s.\n", socket_path);
+    fflush(stdout);
+
+    while (1) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        Connection* connection = (Connection*)mallocArray(1, sizeof(Connection), "connection");
+        connection->state = &state;
+        connection->fd = fd;
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, connectionThread, connection) != 0) {
+            close(fd);
+            free(connection);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+}
+
+#endif
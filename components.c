@@ -0,0 +1,138 @@
+// components.c
+#include <stdio.h>
+#include <stdlib.h>
+#include "components.h"
+
+// Iterative breadth-first search, so component size is bounded by memory, not stack depth
+int connectedComponents(Graph* graph, int* component) {
+    int V = graph->V;
+    int* queue = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    if (!queue) {
+        fprintf(stderr, "Memory allocation failed for BFS queue\n");
+        exit(1);
+    }
+    for (int v = 0; v < V; ++v) {
+        component[v] = -1;
+    }
+
+    int component_count = 0;
+    for (int s = 0; s < V; ++s) {
+        if (component[s] >= 0) {
+            continue;
+        }
+        int head = 0;
+        int tail = 0;
+        queue[tail++] = s;
+        component[s] = component_count;
+        while (head < tail) {
+            int v = queue[head++];
+            NeighborIterator it;
+            int u;
+            for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &u);) {
+                if (component[u] < 0) {
+                    component[u] = component_count;
+                    queue[tail++] = u;
+                }
+            }
+        }
+        component_count++;
+    }
+
+    free(queue);
+    return component_count;
+}
+
+// ATOMIC_PARENT is 0 when the compiler offers no compare-and-swap; the hooking and flattening
+// loops then run on a single thread, since plain reads and writes of parent would race
+#if defined(__GNUC__)
+#define LOAD_PARENT(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define STORE_PARENT(p, value) __atomic_store_n((p), (value), __ATOMIC_RELAXED)
+#define CAS_PARENT(p, expected, desired) __sync_bool_compare_and_swap((p), (expected), (desired))
+#define ATOMIC_PARENT 1
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define LOAD_PARENT(p) (*(volatile int*)(p))
+#define STORE_PARENT(p, value) (*(volatile int*)(p) = (value))
+#define CAS_PARENT(p, expected, desired) \
+    (_InterlockedCompareExchange((volatile long*)(p), (desired), (expected)) == (expected))
+#define ATOMIC_PARENT 1
+#else
+#define LOAD_PARENT(p) (*(p))
+#define STORE_PARENT(p, value) (*(p) = (value))
+#define CAS_PARENT(p, expected, desired) (*(p) == (expected) ? (*(p) = (desired), 1) : 0)
+#define ATOMIC_PARENT 0
+#endif
+
+static int findParentRoot(int* parent, int x) {
+    int p = LOAD_PARENT(&parent[x]);
+    while (p != x) {
+        x = p;
+        p = LOAD_PARENT(&parent[x]);
+    }
+    return x;
+}
+
+// Lock-free union: the larger root is hooked under the smaller one, so every tree is
+// rooted at the smallest vertex of its component
+static void linkVertices(int* parent, int u, int v) {
+    while (1) {
+        int ru = findParentRoot(parent, u);
+        int rv = findParentRoot(parent, v);
+        if (ru == rv) {
+            return;
+        }
+        if (ru > rv) {
+            int t = ru;
+            ru = rv;
+            rv = t;
+        }
+        if (CAS_PARENT(&parent[rv], rv, ru)) {
+            return;
+        }
+    }
+}
+
+// Shiloach-Vishkin style union-find: every thread hooks the edges of its vertices
+// concurrently, then the trees are flattened and renumbered
+int connectedComponentsParallel(Graph* graph, int* component) {
+    int V = graph->V;
+    int* parent = component; // The output array doubles as the union-find forest
+
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < V; ++v) {
+        parent[v] = v;
+    }
+
+    #pragma omp parallel for schedule(dynamic, 256) if(ATOMIC_PARENT)
+    for (int v = 0; v < V; ++v) {
+        NeighborIterator it;
+        int u;
+        for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &u);) {
+            linkVertices(parent, v, u);
+        }
+    }
+
+    // Other threads may still be walking through v while it is pointed at its root
+    #pragma omp parallel for schedule(static) if(ATOMIC_PARENT)
+    for (int v = 0; v < V; ++v) {
+        STORE_PARENT(&parent[v], findParentRoot(parent, v));
+    }
+
+    // Roots are the smallest vertex of each component, so a single ordered pass that
+    // meets every root before its members assigns the BFS numbering
+    int component_count = 0;
+    for (int v = 0; v < V; ++v) {
+        if (parent[v] == v) {
+            component[v] = -(++component_count); // Temporarily negative to mark roots
+        } else {
+            int root = parent[v];
+            component[v] = component[root];
+        }
+    }
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < V; ++v) {
+        component[v] = -component[v] - 1;
+    }
+
+    return component_count;
+}
@@ -0,0 +1,13 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "graph.h"
+
+// Both functions fill component[v] for every vertex and return the number of components.
+// Components are numbered 0, 1, ... in order of their smallest vertex, so the two
+// variants produce identical labelings on undirected graphs. Edges are followed as they
+// are stored; on a directed graph the parallel variant yields weakly connected components.
+int connectedComponents(Graph* graph, int* component);
+int connectedComponentsParallel(Graph* graph, int* component);
+
+#endif // COMPONENTS_H
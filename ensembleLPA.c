@@ -0,0 +1,61 @@
+// ensembleLPA.c
+#include <stdio.h>
+#include <stdlib.h>
+#include "ensembleLPA.h"
+#include "labelPropagation.h"
+#include "components.h"
+
+void labelPropagationEnsemble(Graph* graph, int* labels, int run_count, unsigned int base_seed) {
+    int V = graph->V;
+    if (run_count < 1) {
+        run_count = 1;
+    }
+    printf("Running %d label propagation runs concurrently...\n", run_count);
+
+    int* run_labels = (int*)mallocArray((size_t)run_count * V, sizeof(int), "ensemble labels");
+    int* run_iterations = (int*)mallocArray(run_count, sizeof(int), "ensemble iterations");
+
+    // One run per thread; each run only writes its own label array
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int r = 0; r < run_count; ++r) {
+        int* run = run_labels + (size_t)r * V;
+        unsigned int rng;
+        seedRandom(&rng, base_seed + (unsigned int)r);
+        initializeLabels(run, V);
+        run_iterations[r] = propagateLabels(graph, run, &rng);
+    }
+    for (int r = 0; r < run_count; ++r) {
+        printf("Run %d (seed %u) finished after %d iterations.\n", r, base_seed + (unsigned int)r, run_iterations[r]);
+    }
+
+    // Consensus graph: the edges whose endpoints most runs put together. Undirected
+    // edges are visited once through v < dest, since addEdge stores both directions.
+    Graph* consensus = createGraph(V, graph->directed);
+    long long kept = 0;
+    for (int v = 0; v < V; ++v) {
+        NeighborIterator it;
+        int dest;
+        for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &dest);) {
+            if (!graph->directed && dest <= v) {
+                continue;
+            }
+            int agree = 0;
+            for (int r = 0; r < run_count; ++r) {
+                const int* run = run_labels + (size_t)r * V;
+                agree += run[v] == run[dest];
+            }
+            if (2 * agree > run_count) {
+                addEdge(consensus, v, dest);
+                kept++;
+            }
+        }
+    }
+    printf("Consensus kept %lld of %lld edges.\n", kept, graph->E);
+
+    int community_count = connectedComponentsParallel(consensus, labels);
+    printf("Consensus partition has %d communities.\n", community_count);
+
+    freeGraph(consensus);
+    free(run_iterations);
+    free(run_labels);
+}
@@ -0,0 +1,14 @@
+#ifndef ENSEMBLE_LPA_H
+#define ENSEMBLE_LPA_H
+
+#include "graph.h"
+
+// Runs run_count label propagations concurrently over the same read-only graph, run r
+// shuffling with its own generator seeded by base_seed + r, then writes a consensus
+// partition to labels. An edge is kept when more than half of the runs put both of its
+// endpoints in the same community, and the consensus communities are the connected
+// components of the kept edges, numbered 0, 1, ... in order of their smallest vertex.
+// Only the run_count label arrays are per run; the adjacency is shared.
+void labelPropagationEnsemble(Graph* graph, int* labels, int run_count, unsigned int base_seed);
+
+#endif // ENSEMBLE_LPA_H
@@ -0,0 +1,347 @@
+// externalGraph.c
+#ifndef _WIN32
+#define _GNU_SOURCE // fseeko/ftello are hidden under a strict -std=c11
+#define _FILE_OFFSET_BITS 64 // 64-bit off_t for fseeko/ftello on 32-bit hosts
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "externalGraph.h"
+#include "graph.h"
+
+#define PARTITION_MAGIC "LPAPART1"
+
+// Seeks beyond 2 GB need the 64-bit variants on both platforms
+#ifdef _WIN32
+#define seekFile(file, offset) _fseeki64((file), (offset), SEEK_SET)
+#define tellFile(file) _ftelli64(file)
+#else
+#define seekFile(file, offset) fseeko((file), (off_t)(offset), SEEK_SET)
+#define tellFile(file) ((long long)ftello(file))
+#endif
+
+void writeOrDie(const void* data, size_t size, size_t count, FILE* file) {
+    if (fwrite(data, size, count, file) != count) {
+        fprintf(stderr, "Write failed for partitioned graph\n");
+        exit(1);
+    }
+}
+
+void readOrDie(void* data, size_t size, size_t count, FILE* file) {
+    if (fread(data, size, count, file) != count) {
+        fprintf(stderr, "Read failed for partitioned graph\n");
+        exit(1);
+    }
+}
+
+// Pairs buffered per partition while spilling: the partition budget spread over all
+// partitions, within these bounds
+#define SPILL_BLOCK_MIN 256
+#define SPILL_BLOCK_MAX 65536
+
+// Partition holding vertex v; partitions cover consecutive vertex ranges in order
+int findPartition(const PartitionInfo* partitions, int partition_count, int v) {
+    int low = 0;
+    int high = partition_count - 1;
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        if (partitions[mid].first_vertex <= v) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+// Writes count spilled pairs at pair index position of the spill file
+void flushSpill(FILE* spill, const int* pairs, int count, long long position) {
+    if (count == 0) {
+        return;
+    }
+    if (seekFile(spill, position * 2 * (long long)sizeof(int)) != 0) {
+        fprintf(stderr, "Seek failed for spill file\n");
+        exit(1);
+    }
+    writeOrDie(pairs, 2 * sizeof(int), count, spill);
+}
+
+void convertEdgeListToPartitions(const char* edge_filename, const char* partition_filename,
+                                 int V, int directed, long long max_partition_entries) {
+    FILE* edges = fopen(edge_filename, "r");
+    if (!edges) {
+        fprintf(stderr, "Unable to open file %s\n", edge_filename);
+        exit(1);
+    }
+    printf("Converting %s into partitions of up to %lld entries...\n", edge_filename, max_partition_entries);
+
+    // Pass 1: degrees, which is the only per-vertex state the conversion keeps
+    int* degrees = (int*)calloc(V, sizeof(int));
+    if (!degrees) {
+        fprintf(stderr, "Memory allocation failed for degrees\n");
+        exit(1);
+    }
+    int src, dest;
+    while (fscanf(edges, "%d %d", &src, &dest) == 2) {
+        if (src < 0 || src >= V || dest < 0 || dest >= V) {
+            fprintf(stderr, "Edge %d -> %d out of range\n", src, dest);
+            exit(1);
+        }
+        degrees[src]++;
+        if (!directed) {
+            degrees[dest]++;
+        }
+    }
+
+    // Cut the vertex range greedily by entry budget
+    int partition_count = 0;
+    int partition_capacity = 16;
+    PartitionInfo* partitions = (PartitionInfo*)malloc(partition_capacity * sizeof(PartitionInfo));
+    if (!partitions) {
+        fprintf(stderr, "Memory allocation failed for partitions\n");
+        exit(1);
+    }
+    int max_degree = 0;
+    int max_vertices = 0;
+    long long max_entries = 0;
+    int first = 0;
+    long long entries = 0;
+    for (int v = 0; v <= V; ++v) {
+        int full = v < V && v > first && entries + degrees[v] > max_partition_entries;
+        if (full || (v == V && V > 0)) {
+            if (partition_count >= partition_capacity) {
+                partition_capacity *= 2;
+                partitions = (PartitionInfo*)realloc(partitions, partition_capacity * sizeof(PartitionInfo));
+                if (!partitions) {
+                    fprintf(stderr, "Memory allocation failed for partitions\n");
+                    exit(1);
+                }
+            }
+            partitions[partition_count].first_vertex = first;
+            partitions[partition_count].last_vertex = v;
+            partitions[partition_count].file_offset = 0;
+            partitions[partition_count].entry_count = entries;
+            partition_count++;
+            if (entries > max_entries) {
+                max_entries = entries;
+            }
+            if (v - first > max_vertices) {
+                max_vertices = v - first;
+            }
+            first = v;
+            entries = 0;
+        }
+        if (v < V) {
+            entries += degrees[v];
+            if (degrees[v] > max_degree) {
+                max_degree = degrees[v];
+            }
+        }
+    }
+
+    FILE* out = fopen(partition_filename, "wb");
+    if (!out) {
+        fprintf(stderr, "Unable to create file %s\n", partition_filename);
+        exit(1);
+    }
+
+    // Header and partition table; the table is rewritten once data offsets are known
+    writeOrDie(PARTITION_MAGIC, 1, 8, out);
+    writeOrDie(&V, sizeof(int), 1, out);
+    writeOrDie(&directed, sizeof(int), 1, out);
+    writeOrDie(&max_degree, sizeof(int), 1, out);
+    writeOrDie(&partition_count, sizeof(int), 1, out);
+    long long table_offset = tellFile(out);
+    writeOrDie(partitions, sizeof(PartitionInfo), partition_count, out);
+
+    // Pass 2: one scan of the edge list spills every neighbor entry, as a (vertex, neighbor)
+    // pair, into its partition's region of a scratch file. Each partition buffers a block of
+    // pairs, so the spill is written in blocks rather than one entry at a time.
+    size_t name_length = strlen(partition_filename);
+    char* spill_filename = (char*)mallocArray(name_length + 7, 1, "spill file name");
+    memcpy(spill_filename, partition_filename, name_length);
+    memcpy(spill_filename + name_length, ".spill", 7);
+    FILE* spill = fopen(spill_filename, "w+b");
+    if (!spill) {
+        fprintf(stderr, "Unable to create file %s\n", spill_filename);
+        exit(1);
+    }
+    long long block = max_partition_entries / (partition_count > 0 ? partition_count : 1);
+    if (block < SPILL_BLOCK_MIN) {
+        block = SPILL_BLOCK_MIN;
+    } else if (block > SPILL_BLOCK_MAX) {
+        block = SPILL_BLOCK_MAX;
+    }
+    long long* spilled = (long long*)mallocArray(partition_count, sizeof(long long), "spill cursors");
+    int* pending = (int*)callocArray(partition_count, sizeof(int), "spill blocks");
+    int* blocks = (int*)mallocArray((size_t)partition_count * block, 2 * sizeof(int), "spill blocks");
+    long long region = 0;
+    for (int p = 0; p < partition_count; ++p) {
+        spilled[p] = region;
+        region += partitions[p].entry_count;
+    }
+
+    rewind(edges);
+    while (fscanf(edges, "%d %d", &src, &dest) == 2) {
+        for (int side = 0; side < (directed ? 1 : 2); ++side) {
+            int vertex = side ? dest : src;
+            int p = findPartition(partitions, partition_count, vertex);
+            int* pair = blocks + 2 * ((long long)p * block + pending[p]);
+            pair[0] = vertex;
+            pair[1] = side ? src : dest;
+            if (++pending[p] == block) {
+                flushSpill(spill, blocks + 2 * (long long)p * block, pending[p], spilled[p]);
+                spilled[p] += pending[p];
+                pending[p] = 0;
+            }
+        }
+    }
+    for (int p = 0; p < partition_count; ++p) {
+        flushSpill(spill, blocks + 2 * (long long)p * block, pending[p], spilled[p]);
+    }
+
+    // Pass 3: build each partition from its own region of the spill, read sequentially
+    long long* cursor = (long long*)malloc((max_vertices + 1) * sizeof(long long));
+    int* neighbors = (int*)malloc((max_entries > 0 ? max_entries : 1) * sizeof(int));
+    if (!cursor || !neighbors) {
+        fprintf(stderr, "Memory allocation failed for partition buffer\n");
+        exit(1);
+    }
+    region = 0;
+    for (int p = 0; p < partition_count; ++p) {
+        int lo = partitions[p].first_vertex;
+        int hi = partitions[p].last_vertex;
+        cursor[0] = 0;
+        for (int v = lo; v < hi; ++v) {
+            cursor[v - lo + 1] = cursor[v - lo] + degrees[v];
+        }
+
+        if (seekFile(spill, region * 2 * (long long)sizeof(int)) != 0) {
+            fprintf(stderr, "Seek failed for spill file %s\n", spill_filename);
+            exit(1);
+        }
+        for (long long e = 0; e < partitions[p].entry_count; e += block) {
+            long long count = partitions[p].entry_count - e < block ? partitions[p].entry_count - e : block;
+            readOrDie(blocks, 2 * sizeof(int), count, spill);
+            for (long long i = 0; i < count; ++i) {
+                neighbors[cursor[blocks[2 * i] - lo]++] = blocks[2 * i + 1];
+            }
+        }
+        region += partitions[p].entry_count;
+
+        partitions[p].file_offset = tellFile(out);
+        writeOrDie(degrees + lo, sizeof(int), hi - lo, out);
+        writeOrDie(neighbors, sizeof(int), partitions[p].entry_count, out);
+    }
+    fclose(spill);
+    remove(spill_filename);
+    free(spill_filename);
+    free(spilled);
+    free(pending);
+    free(blocks);
+
+    seekFile(out, table_offset);
+    writeOrDie(partitions, sizeof(PartitionInfo), partition_count, out);
+    if (fclose(out) != 0) {
+        fprintf(stderr, "Write failed for partitioned graph\n");
+        exit(1);
+    }
+    fclose(edges);
+    printf("Wrote %d partitions to %s.\n", partition_count, partition_filename);
+
+    free(cursor);
+    free(neighbors);
+    free(partitions);
+    free(degrees);
+}
+
+ExternalGraph* openExternalGraph(const char* partition_filename) {
+    FILE* file = fopen(partition_filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Unable to open file %s\n", partition_filename);
+        exit(1);
+    }
+    char magic[8];
+    readOrDie(magic, 1, 8, file);
+    if (memcmp(magic, PARTITION_MAGIC, 8) != 0) {
+        fprintf(stderr, "%s is not a partitioned graph\n", partition_filename);
+        exit(1);
+    }
+
+    ExternalGraph* graph = (ExternalGraph*)malloc(sizeof(ExternalGraph));
+    if (!graph) {
+        fprintf(stderr, "Memory allocation failed for external graph\n");
+        exit(1);
+    }
+    graph->file = file;
+    readOrDie(&graph->V, sizeof(int), 1, file);
+    readOrDie(&graph->directed, sizeof(int), 1, file);
+    readOrDie(&graph->max_degree, sizeof(int), 1, file);
+    readOrDie(&graph->partition_count, sizeof(int), 1, file);
+    graph->partitions = (PartitionInfo*)malloc((graph->partition_count > 0 ? graph->partition_count : 1) * sizeof(PartitionInfo));
+    if (!graph->partitions) {
+        fprintf(stderr, "Memory allocation failed for partition table\n");
+        exit(1);
+    }
+    readOrDie(graph->partitions, sizeof(PartitionInfo), graph->partition_count, file);
+
+    graph->max_entries = 0;
+    for (int p = 0; p < graph->partition_count; ++p) {
+        if (graph->partitions[p].entry_count > graph->max_entries) {
+            graph->max_entries = graph->partitions[p].entry_count;
+        }
+    }
+    return graph;
+}
+
+void closeExternalGraph(ExternalGraph* graph) {
+    fclose(graph->file);
+    free(graph->partitions);
+    free(graph);
+}
+
+// Sizes a buffer for the largest partition, so loads never reallocate
+void initPartitionBuffer(ExternalGraph* graph, PartitionBuffer* buffer) {
+    int max_vertices = 0;
+    for (int p = 0; p < graph->partition_count; ++p) {
+        int count = graph->partitions[p].last_vertex - graph->partitions[p].first_vertex;
+        if (count > max_vertices) {
+            max_vertices = count;
+        }
+    }
+    buffer->partition = -1;
+    buffer->first_vertex = 0;
+    buffer->last_vertex = 0;
+    buffer->degrees = (int*)malloc((max_vertices > 0 ? max_vertices : 1) * sizeof(int));
+    buffer->offsets = (long long*)malloc((max_vertices + 1) * sizeof(long long));
+    buffer->neighbors = (int*)malloc((graph->max_entries > 0 ? graph->max_entries : 1) * sizeof(int));
+    if (!buffer->degrees || !buffer->offsets || !buffer->neighbors) {
+        fprintf(stderr, "Memory allocation failed for partition buffer\n");
+        exit(1);
+    }
+}
+
+void loadPartition(ExternalGraph* graph, int partition, PartitionBuffer* buffer) {
+    PartitionInfo* info = &graph->partitions[partition];
+    int count = info->last_vertex - info->first_vertex;
+    if (seekFile(graph->file, info->file_offset) != 0) {
+        fprintf(stderr, "Seek failed for partition %d\n", partition);
+        exit(1);
+    }
+    readOrDie(buffer->degrees, sizeof(int), count, graph->file);
+    readOrDie(buffer->neighbors, sizeof(int), info->entry_count, graph->file);
+
+    buffer->offsets[0] = 0;
+    for (int i = 0; i < count; ++i) {
+        buffer->offsets[i + 1] = buffer->offsets[i] + buffer->degrees[i];
+    }
+    buffer->partition = partition;
+    buffer->first_vertex = info->first_vertex;
+    buffer->last_vertex = info->last_vertex;
+}
+
+void freePartitionBuffer(PartitionBuffer* buffer) {
+    free(buffer->degrees);
+    free(buffer->offsets);
+    free(buffer->neighbors);
+}
@@ -0,0 +1,53 @@
+#ifndef EXTERNAL_GRAPH_H
+#define EXTERNAL_GRAPH_H
+
+#include <stdio.h>
+
+// Disk-backed adjacency for graphs that do not fit in memory. The vertex range is split
+// into partitions of consecutive vertices, each stored as its vertices' degrees followed by
+// their neighbor lists, so one partition is read with a single sequential read.
+typedef struct {
+    int first_vertex;       // First vertex of the partition
+    int last_vertex;        // One past the last vertex
+    long long file_offset;  // Byte offset of the partition data
+    long long entry_count;  // Number of neighbor entries
+} PartitionInfo;
+
+typedef struct {
+    FILE* file;
+    int V;
+    int directed;
+    int max_degree;
+    int partition_count;
+    long long max_entries;  // Largest entry_count of any partition
+    PartitionInfo* partitions;
+} ExternalGraph;
+
+// One partition loaded in memory; neighbors of vertex first_vertex + i are
+// neighbors[offsets[i]] .. neighbors[offsets[i + 1] - 1]
+typedef struct {
+    int partition;
+    int first_vertex;
+    int last_vertex;
+    int* degrees;
+    long long* offsets;
+    int* neighbors;
+} PartitionBuffer;
+
+// Converts an edge list into a partitioned file with at most max_partition_entries
+// neighbor entries per partition (a single vertex may exceed it). The edge list is read
+// twice: once for the degrees, and once to spill every entry into its partition's region
+// of a scratch file next to the output. Each partition is then built from its region.
+// Only per-vertex degrees, one partition and a block of pending entries per partition
+// are held in memory.
+void convertEdgeListToPartitions(const char* edge_filename, const char* partition_filename,
+                                 int V, int directed, long long max_partition_entries);
+
+ExternalGraph* openExternalGraph(const char* partition_filename);
+void closeExternalGraph(ExternalGraph* graph);
+
+void initPartitionBuffer(ExternalGraph* graph, PartitionBuffer* buffer);
+void loadPartition(ExternalGraph* graph, int partition, PartitionBuffer* buffer);
+void freePartitionBuffer(PartitionBuffer* buffer);
+
+#endif // EXTERNAL_GRAPH_H
@@ -1,20 +1,92 @@
 // graph.c
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include "graph.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SNAPSHOT_MAGIC "LPASNAP1"
+
+// Snapshot layout: this header, offsets[V + 1], degrees[V], then data_size bytes of
+// varint-encoded neighbor lists
+typedef struct {
+    char magic[8];
+    int V;
+    int directed;
+    long long E;
+    long long data_size;
+} SnapshotHeader;
+
+static void releaseSnapshot(void* mapping, size_t size);
+
+static int checkArraySize(size_t count, size_t size, const char* what) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        fprintf(stderr, "Allocation size overflow for %s (%zu x %zu bytes)\n", what, count, size);
+        exit(1);
+    }
+    return 1;
+}
+
+void* mallocArray(size_t count, size_t size, const char* what) {
+    checkArraySize(count, size, what);
+    void* ptr = malloc(count * size > 0 ? count * size : 1);
+    if (!ptr) {
+        fprintf(stderr, "Memory allocation failed for %s\n", what);
+        exit(1);
+    }
+    return ptr;
+}
+
+void* callocArray(size_t count, size_t size, const char* what) {
+    checkArraySize(count, size, what);
+    void* ptr = calloc(count > 0 ? count : 1, size > 0 ? size : 1);
+    if (!ptr) {
+        fprintf(stderr, "Memory allocation failed for %s\n", what);
+        exit(1);
+    }
+    return ptr;
+}
+
+void* reallocArray(void* ptr, size_t count, size_t size, const char* what) {
+    checkArraySize(count, size, what);
+    void* grown = realloc(ptr, count * size > 0 ? count * size : 1);
+    if (!grown) {
+        fprintf(stderr, "Memory allocation failed for %s\n", what);
+        exit(1);
+    }
+    return grown;
+}
+
 Graph* createGraph(int V, int directed) {
-    Graph* graph = (Graph*) malloc(sizeof(Graph));
+    if (V < 0) {
+        fprintf(stderr, "Invalid vertex count %d\n", V);
+        exit(1);
+    }
+    Graph* graph = (Graph*) mallocArray(1, sizeof(Graph), "graph structure");
     graph->V = V;
     graph->E = 0;
     graph->directed = directed;
-    graph->array = (AdjList*) malloc(V * sizeof(AdjList));
+    graph->compressed = NULL;
+    graph->reverse = NULL;
+    graph->array = (AdjList*) mallocArray(V, sizeof(AdjList), "adjacency lists");
     for (int i = 0; i < V; ++i) {
         graph->array[i].head = NULL;
     }
     return graph;
 }
 void addEdge(Graph* graph, int src, int dest) {
+    if (graph->compressed) {
+        fprintf(stderr, "Cannot add edges to a compressed graph\n");
+        exit(1);
+    }
     Node* newNode = (Node*) malloc(sizeof(Node));
     if (!newNode) {
         fprintf(stderr, "Memory allocation failed for new node\n");
@@ -33,11 +105,47 @@ void addEdge(Graph* graph, int src, int dest) {
         newNode->dest = src;
         newNode->next = graph->array[dest].head;
         graph->array[dest].head = newNode;
+    } else if (graph->reverse) {
+        addEdge(graph->reverse, dest, src);
     }
 
     graph->E++;
 }
 
+// Unlinks one occurrence of dest from the adjacency list of src. Returns 1 if it was found.
+int removeFromList(Graph* graph, int src, int dest) {
+    Node** link = &graph->array[src].head;
+    while (*link) {
+        if ((*link)->dest == dest) {
+            Node* temp = *link;
+            *link = temp->next;
+            free(temp);
+            return 1;
+        }
+        link = &(*link)->next;
+    }
+    return 0;
+}
+
+// Removes one src -> dest edge (and its reverse for undirected graphs). Returns 1 if the
+// edge existed.
+int removeEdge(Graph* graph, int src, int dest) {
+    if (graph->compressed) {
+        fprintf(stderr, "Cannot remove edges from a compressed graph\n");
+        exit(1);
+    }
+    if (!removeFromList(graph, src, dest)) {
+        return 0;
+    }
+    if (!graph->directed) {
+        removeFromList(graph, dest, src);
+    } else if (graph->reverse) {
+        removeEdge(graph->reverse, dest, src);
+    }
+    graph->E--;
+    return 1;
+}
+
 Graph* createGraphFromFile(const char* filename, int V, int directed) {
     FILE* file = fopen(filename, "r");
     if (!file) {
@@ -55,22 +163,69 @@ Graph* createGraphFromFile(const char* filename, int V, int directed) {
     printf("Graph structure created successfully.\n");
 
     int src, dest;
-    int edge_count = 0;
-    while (fscanf(file, "%d %d", &src, &dest) != EOF) {
+    long long edge_count = 0;
+    while (fscanf(file, "%d %d", &src, &dest) == 2) {
+        if (src < 0 || src >= V || dest < 0 || dest >= V) {
+            fprintf(stderr, "Edge %d -> %d is outside the %d vertices\n", src, dest, V);
+            exit(1);
+        }
         addEdge(graph, src, dest);
         edge_count++;
         // if (edge_count % 100000 == 0) {
-        //     printf("%d edges added...\n", edge_count);
+        //     printf("%lld edges added...\n", edge_count);
         // }
     }
-    printf("Total %d edges added successfully.\n", edge_count);
+    printf("Total %lld edges added successfully.\n", edge_count);
 
     fclose(file);
     printf("File closed successfully.\n");
     return graph;
 }
 
-void freeGraph(Graph* graph) {
+// Reads a batch of edge updates, one per line: "+ src dest" inserts an edge and
+// "- src dest" deletes it
+EdgeUpdate* readEdgeUpdates(const char* filename, int V, int* update_count) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Unable to open file %s\n", filename);
+        exit(1);
+    }
+
+    size_t capacity = 1024;
+    EdgeUpdate* updates = (EdgeUpdate*)mallocArray(capacity, sizeof(EdgeUpdate), "edge updates");
+    *update_count = 0;
+
+    char op;
+    int src, dest;
+    while (fscanf(file, " %c %d %d", &op, &src, &dest) == 3) {
+        if (op != '+' && op != '-') {
+            fprintf(stderr, "Unknown edge update '%c' in %s\n", op, filename);
+            continue;
+        }
+        if (src < 0 || src >= V || dest < 0 || dest >= V) {
+            fprintf(stderr, "Skipping edge update %d -> %d: node out of range\n", src, dest);
+            continue;
+        }
+        if (*update_count == INT_MAX) {
+            fprintf(stderr, "Too many edge updates in %s\n", filename);
+            exit(1);
+        }
+        if ((size_t)*update_count >= capacity) {
+            capacity *= 2;
+            updates = (EdgeUpdate*)reallocArray(updates, capacity, sizeof(EdgeUpdate), "edge updates");
+        }
+        updates[*update_count].src = src;
+        updates[*update_count].dest = dest;
+        updates[*update_count].insert = (op == '+');
+        (*update_count)++;
+    }
+    printf("Read %d edge updates.\n", *update_count);
+
+    fclose(file);
+    return updates;
+}
+
+void freeAdjacencyLists(Graph* graph) {
     for (int v = 0; v < graph->V; ++v) {
         Node* node = graph->array[v].head;
         while (node) {
@@ -80,14 +235,140 @@ void freeGraph(Graph* graph) {
         }
     }
     free(graph->array);
+    graph->array = NULL;
+}
+
+void freeGraph(Graph* graph) {
+    if (graph->reverse) {
+        freeGraph(graph->reverse);
+    }
+    if (graph->array) {
+        freeAdjacencyLists(graph);
+    }
+    if (graph->compressed) {
+        if (graph->compressed->mapping) {
+            releaseSnapshot(graph->compressed->mapping, graph->compressed->mapping_size);
+        } else {
+            free(graph->compressed->offsets);
+            free(graph->compressed->degrees);
+            free(graph->compressed->data);
+        }
+        free(graph->compressed);
+    }
     free(graph);
 }
 
+int vertexDegree(const Graph* graph, int v) {
+    if (graph->compressed) {
+        return graph->compressed->degrees[v];
+    }
+    int degree = 0;
+    Node* node = graph->array[v].head;
+    while (node) {
+        degree++;
+        node = node->next;
+    }
+    return degree;
+}
+
+int compare(const void* a, const void* b);
+
+// Replaces the linked lists by sorted, gap-encoded varint lists. Duplicate edges are kept
+// (as zero gaps), so every algorithm sees the same multiset of neighbors as before; only
+// their order changes. The graph becomes read-only.
+void compressGraph(Graph* graph) {
+    if (graph->reverse) {
+        compressGraph(graph->reverse);
+    }
+    if (graph->compressed) {
+        return;
+    }
+    int V = graph->V;
+    CompressedAdjacency* compressed = (CompressedAdjacency*)malloc(sizeof(CompressedAdjacency));
+    if (!compressed) {
+        fprintf(stderr, "Memory allocation failed for compressed graph\n");
+        exit(1);
+    }
+    compressed->mapping = NULL;
+    compressed->mapping_size = 0;
+    compressed->offsets = (long long*)mallocArray((size_t)V + 1, sizeof(long long), "compressed offsets");
+    compressed->degrees = (int*)mallocArray(V, sizeof(int), "compressed degrees");
+
+    int max_degree = 0;
+    long long list_bytes = 0;
+    for (int v = 0; v < V; ++v) {
+        compressed->degrees[v] = vertexDegree(graph, v);
+        if (compressed->degrees[v] > max_degree) {
+            max_degree = compressed->degrees[v];
+        }
+        list_bytes += compressed->degrees[v] * (long long)sizeof(Node);
+    }
+
+    size_t capacity = 1024;
+    compressed->data = (unsigned char*)mallocArray(capacity, 1, "compressed adjacency");
+    int* list = (int*)mallocArray(max_degree, sizeof(int), "neighbor list");
+
+    long long size = 0;
+    for (int v = 0; v < V; ++v) {
+        int degree = 0;
+        Node* node = graph->array[v].head;
+        while (node) {
+            list[degree++] = node->dest;
+            node = node->next;
+        }
+        qsort(list, degree, sizeof(int), compare);
+
+        // A varint takes at most 5 bytes
+        while ((size_t)size + 5 * (size_t)degree > capacity) {
+            capacity *= 2;
+            compressed->data = (unsigned char*)reallocArray(compressed->data, capacity, 1, "compressed adjacency");
+        }
+
+        compressed->offsets[v] = size;
+        int previous = 0;
+        for (int i = 0; i < degree; ++i) {
+            unsigned int gap = (unsigned int)(list[i] - previous);
+            previous = list[i];
+            while (gap >= 0x80) {
+                compressed->data[size++] = (unsigned char)(gap | 0x80);
+                gap >>= 7;
+            }
+            compressed->data[size++] = (unsigned char)gap;
+        }
+    }
+    compressed->offsets[V] = size;
+    compressed->data = (unsigned char*)reallocArray(compressed->data, size, 1, "compressed adjacency");
+    free(list);
+
+    freeAdjacencyLists(graph);
+    graph->compressed = compressed;
+    printf("Compressed adjacency: %lld bytes (linked lists used %lld bytes).\n", size, list_bytes);
+}
+
 
 int compare(const void* a, const void* b) {
     return (*(int*)a - *(int*)b);
 }
 
+void buildReverseIndex(Graph* graph) {
+    if (!graph->directed || graph->reverse) {
+        return;
+    }
+    Graph* reverse = createGraph(graph->V, 1);
+    for (int v = 0; v < graph->V; ++v) {
+        NeighborIterator it;
+        int dest;
+        for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &dest);) {
+            addEdge(reverse, dest, v);
+        }
+    }
+    if (graph->compressed) {
+        compressGraph(reverse);
+    }
+    graph->reverse = reverse;
+    printf("Reverse index built with %lld in-edges.\n", reverse->E);
+}
+
 Graph* createGraphFromFileWithMapping(const char* filename, int V, int directed) {
     FILE* file = fopen(filename, "r");
     if (!file) {
@@ -104,43 +385,55 @@ Graph* createGraphFromFileWithMapping(const char* filename, int V, int directed)
     }
     printf("Graph structure created successfully.\n");
 
-    int* node_ids = (int*)malloc(2 * V * sizeof(int));
-    int node_count = 0;
+    // Two IDs per edge, so the buffer grows with the edge count rather than with V
+    size_t node_capacity = 1024;
+    size_t node_count = 0;
+    int* node_ids = (int*)mallocArray(node_capacity, sizeof(int), "node IDs");
 
     int src, dest;
-    while (fscanf(file, "%d %d", &src, &dest) != EOF) {
+    while (fscanf(file, "%d %d", &src, &dest) == 2) {
+        if (node_count + 2 > node_capacity) {
+            node_capacity *= 2;
+            node_ids = (int*)reallocArray(node_ids, node_capacity, sizeof(int), "node IDs");
+        }
         node_ids[node_count++] = src;
         node_ids[node_count++] = dest;
     }
 
     qsort(node_ids, node_count, sizeof(int), compare);
 
-    int unique_count = 0;
-    for (int i = 1; i < node_count; ++i) {
+    size_t unique_count = 0;
+    for (size_t i = 1; i < node_count; ++i) {
         if (node_ids[i] != node_ids[unique_count]) {
             node_ids[++unique_count] = node_ids[i];
         }
     }
-    unique_count++;
+    if (node_count > 0) {
+        unique_count++;
+    }
+    if (unique_count > (size_t)V) {
+        fprintf(stderr, "File %s has %zu distinct nodes but the graph has %d vertices\n", filename, unique_count, V);
+        exit(1);
+    }
 
     rewind(file);
 
-    int edge_count = 0;
-    while (fscanf(file, "%d %d", &src, &dest) != EOF) {
+    long long edge_count = 0;
+    while (fscanf(file, "%d %d", &src, &dest) == 2) {
         int* src_ptr = (int*)bsearch(&src, node_ids, unique_count, sizeof(int), compare);
         int* dest_ptr = (int*)bsearch(&dest, node_ids, unique_count, sizeof(int), compare);
 
-        int src_index = src_ptr - node_ids;
-        int dest_index = dest_ptr - node_ids;
+        int src_index = (int)(src_ptr - node_ids);
+        int dest_index = (int)(dest_ptr - node_ids);
 
         printf("Read edge: %d -> %d (mapped to %d -> %d)\n", src, dest, src_index, dest_index);
         addEdge(graph, src_index, dest_index);
         edge_count++;
         // if (edge_count % 100000 == 0) {
-        //     printf("%d edges added...\n", edge_count);
+        //     printf("%lld edges added...\n", edge_count);
         // }
     }
-    printf("Total %d edges added successfully.\n", edge_count);
+    printf("Total %lld edges added successfully.\n", edge_count);
 
     fclose(file);
     printf("File closed successfully.\n");
@@ -148,4 +441,153 @@ Graph* createGraphFromFileWithMapping(const char* filename, int V, int directed)
     return graph;
 }
 
+static void releaseSnapshot(void* mapping, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    free(mapping);
+#else
+    munmap(mapping, size);
+#endif
+}
 
+void saveGraphSnapshot(Graph* graph, const char* filename) {
+    compressGraph(graph);
+    CompressedAdjacency* compressed = graph->compressed;
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to open file %s\n", filename);
+        exit(1);
+    }
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.V = graph->V;
+    header.directed = graph->directed;
+    header.E = graph->E;
+    header.data_size = compressed->offsets[graph->V];
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(compressed->offsets, sizeof(long long), (size_t)graph->V + 1, file) != (size_t)graph->V + 1 ||
+        fwrite(compressed->degrees, sizeof(int), graph->V, file) != (size_t)graph->V ||
+        fwrite(compressed->data, 1, header.data_size, file) != (size_t)header.data_size ||
+        fclose(file) != 0) {
+        fprintf(stderr, "Write failed for snapshot %s\n", filename);
+        exit(1);
+    }
+    printf("Snapshot written to %s.\n", filename);
+}
+
+// Checks that the offsets tile the data section in order and that each list decodes to
+// exactly degrees[v] neighbors below V without running past its end, so a truncated or
+// stale snapshot is rejected instead of being read out of bounds later
+static int validSnapshotLists(const long long* offsets, const int* degrees, const unsigned char* data, int V,
+                              long long data_size) {
+    if (offsets[0] != 0 || offsets[V] != data_size) {
+        return 0;
+    }
+    for (int v = 0; v < V; ++v) {
+        if (offsets[v + 1] < offsets[v] || offsets[v + 1] > data_size || degrees[v] < 0) {
+            return 0;
+        }
+        const unsigned char* pos = data + offsets[v];
+        const unsigned char* end = data + offsets[v + 1];
+        long long last = 0;
+        int count = 0;
+        while (pos < end) {
+            unsigned int gap = 0;
+            int shift = 0;
+            unsigned char byte;
+            do {
+                if (pos == end || shift > 28) {
+                    return 0; // Varint cut off by the end of the list or longer than 5 bytes
+                }
+                byte = *pos++;
+                gap |= (unsigned int)(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+            last += gap;
+            if (last >= V || count == degrees[v]) {
+                return 0;
+            }
+            count++;
+        }
+        if (count != degrees[v]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+Graph* loadGraphSnapshot(const char* filename) {
+    void* mapping = NULL;
+    size_t size = 0;
+#ifdef _WIN32
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return NULL;
+    }
+    _fseeki64(file, 0, SEEK_END);
+    size = (size_t)_ftelli64(file);
+    _fseeki64(file, 0, SEEK_SET);
+    mapping = mallocArray(size, 1, "snapshot");
+    if (fread(mapping, 1, size, file) != size) {
+        fclose(file);
+        free(mapping);
+        return NULL;
+    }
+    fclose(file);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(SnapshotHeader)) {
+        close(fd);
+        return NULL;
+    }
+    size = (size_t)info.st_size;
+    mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+#endif
+
+    // Validate every section against the file size, then the lists themselves, before
+    // handing out a graph that points into them
+    const SnapshotHeader* header = (const SnapshotHeader*)mapping;
+    int valid = size >= sizeof(SnapshotHeader) && memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 &&
+                header->V >= 0 && header->data_size >= 0;
+    size_t V = valid ? (size_t)header->V : 0;
+    if (valid) {
+        size_t arrays = sizeof(SnapshotHeader) + (V + 1) * sizeof(long long) + V * sizeof(int);
+        valid = size >= arrays && size - arrays == (size_t)header->data_size;
+    }
+    char* base = (char*)mapping + sizeof(SnapshotHeader);
+    if (valid) {
+        valid = validSnapshotLists((const long long*)base, (const int*)(base + (V + 1) * sizeof(long long)),
+                                   (const unsigned char*)(base + (V + 1) * sizeof(long long) + V * sizeof(int)),
+                                   header->V, header->data_size);
+    }
+    if (!valid) {
+        fprintf(stderr, "%s is not a valid graph snapshot\n", filename);
+        releaseSnapshot(mapping, size);
+        return NULL;
+    }
+
+    Graph* graph = (Graph*)mallocArray(1, sizeof(Graph), "graph structure");
+    CompressedAdjacency* compressed = (CompressedAdjacency*)mallocArray(1, sizeof(CompressedAdjacency), "compressed graph");
+    compressed->offsets = (long long*)base;
+    compressed->degrees = (int*)(base + (V + 1) * sizeof(long long));
+    compressed->data = (unsigned char*)(base + (V + 1) * sizeof(long long) + V * sizeof(int));
+    compressed->mapping = mapping;
+    compressed->mapping_size = size;
+    graph->V = header->V;
+    graph->E = header->E;
+    graph->directed = header->directed;
+    graph->array = NULL;
+    graph->compressed = compressed;
+    graph->reverse = NULL;
+    printf("Snapshot %s loaded with %d vertices.\n", filename, graph->V);
+    return graph;
+}
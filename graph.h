@@ -1,6 +1,8 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <stddef.h>
+
 typedef struct Node {
     int dest;
     struct Node* next;
@@ -10,17 +12,120 @@ typedef struct AdjList {
     Node* head;
 } AdjList;
 
+// Read-only compressed adjacency: each neighbor list is sorted and stored as varint-encoded
+// gaps (the first neighbor as a gap from 0). List v occupies data[offsets[v]] ..
+// data[offsets[v + 1] - 1].
+typedef struct CompressedAdjacency {
+    long long* offsets;
+    int* degrees;
+    unsigned char* data;
+    void* mapping;          // Non-NULL when the arrays point into a loaded snapshot
+    size_t mapping_size;
+} CompressedAdjacency;
+
+// Vertex IDs stay 32-bit for cache density; edge counts and adjacency offsets are 64-bit
 typedef struct Graph {
     int V;
-    int E;
+    long long E;
     int directed;
-    AdjList* array;
+    AdjList* array;                  // NULL once the graph is compressed
+    CompressedAdjacency* compressed; // NULL for the linked-list representation
+    struct Graph* reverse;           // In-edge index of a directed graph, NULL until built
 } Graph;
 
+// Walks the neighbors of one vertex in either representation:
+//     NeighborIterator it;
+//     int u;
+//     for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &u);) { ... }
+typedef struct NeighborIterator {
+    const Node* node;
+    const unsigned char* pos;
+    const unsigned char* end;
+    int last;
+} NeighborIterator;
+
+static inline void neighborIteratorInit(const Graph* graph, int v, NeighborIterator* it) {
+    if (graph->compressed) {
+        it->node = NULL;
+        it->pos = graph->compressed->data + graph->compressed->offsets[v];
+        it->end = graph->compressed->data + graph->compressed->offsets[v + 1];
+    } else {
+        it->node = graph->array[v].head;
+        it->pos = NULL;
+        it->end = NULL;
+    }
+    it->last = 0;
+}
+
+static inline int neighborIteratorNext(NeighborIterator* it, int* dest) {
+    if (it->pos) {
+        if (it->pos == it->end) {
+            return 0;
+        }
+        unsigned int gap = 0;
+        int shift = 0;
+        unsigned char byte;
+        do {
+            byte = *it->pos++;
+            gap |= (unsigned int)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        it->last += (int)gap;
+        *dest = it->last;
+        return 1;
+    }
+    if (!it->node) {
+        return 0;
+    }
+    *dest = it->node->dest;
+    it->node = it->node->next;
+    return 1;
+}
+
+int vertexDegree(const Graph* graph, int v);
+
+// The adjacency holding every vertex's in-neighbors: the reverse index of a directed graph,
+// or the graph itself when it is undirected. NULL for a directed graph without an index.
+static inline const Graph* inEdgeGraph(const Graph* graph) {
+    return graph->directed ? graph->reverse : graph;
+}
+
+// Array allocators that reject count * size overflow and exit with a message naming the
+// array when the size is invalid or memory runs out
+void* mallocArray(size_t count, size_t size, const char* what);
+void* callocArray(size_t count, size_t size, const char* what);
+void* reallocArray(void* ptr, size_t count, size_t size, const char* what);
+
+// A single edge change for dynamic graphs: insert = 1 adds src -> dest, insert = 0 removes it
+typedef struct EdgeUpdate {
+    int src;
+    int dest;
+    int insert;
+} EdgeUpdate;
+
 Graph* createGraph(int V, int directed);
 void addEdge(Graph* graph, int src, int dest);
+int removeEdge(Graph* graph, int src, int dest);
 Graph* createGraphFromFile(const char* filename, int V, int directed);
 Graph* createGraphFromFileWithMapping(const char* filename, int V, int directed);
+void compressGraph(Graph* graph);
+
+// Builds the in-edge index of a directed graph as a second graph whose list v holds the
+// sources of v's in-edges (no-op for undirected graphs). addEdge, removeEdge and
+// compressGraph keep it in step with the forward lists from then on.
+void buildReverseIndex(Graph* graph);
+
+// Snapshots store a compressed graph exactly as it sits in memory. saveGraphSnapshot
+// compresses the graph first if needed; loadGraphSnapshot maps the file read-only (POSIX)
+// or reads it in one piece (Windows) and returns a compressed graph whose arrays point
+// into it, so loading costs no parsing beyond one validating pass over the lists. Returns
+// NULL if the file is missing or invalid (sizes, offsets, degrees or neighbor ids).
+// The reverse index is not stored; call buildReverseIndex on the loaded graph if needed.
+void saveGraphSnapshot(Graph* graph, const char* filename);
+Graph* loadGraphSnapshot(const char* filename);
+
+// Reads "+ u v" / "- u v" lines, skipping updates with an endpoint outside [0, V)
+EdgeUpdate* readEdgeUpdates(const char* filename, int V, int* update_count);
 void freeGraph(Graph* graph);
 
 #endif // GRAPH_H
\ No newline at end of file
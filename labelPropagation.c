@@ -0,0 +1,731 @@
+// labelPropagation.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "labelPropagation.h"
+#include "checkpoint.h"
+
+void initializeLabels(int* labels, int V) {
+    for (int i = 0; i < V; ++i) {
+        labels[i] = i;
+    }
+}
+
+void shuffle(int *array, int n) {
+    if (n > 1) {
+        for (int i = 0; i < n - 1; i++) {
+            int j = i + rand() / (RAND_MAX / (n - i) + 1);
+            int t = array[j];
+            array[j] = array[i];
+            array[i] = t;
+        }
+    }
+}
+
+// xorshift32: a generator small enough to keep one per concurrent run
+unsigned int nextRandom(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+void seedRandom(unsigned int* state, unsigned int seed) {
+    *state = seed ? seed : 0x9E3779B9u; // xorshift never leaves the all-zero state
+}
+
+void shuffleWithState(int* array, int n, unsigned int* state) {
+    for (int i = 0; i < n - 1; i++) {
+        int j = i + (int)(nextRandom(state) % (unsigned int)(n - i));
+        int t = array[j];
+        array[j] = array[i];
+        array[i] = t;
+    }
+}
+
+// Nodes with at most this many neighbors vote through a small inline table; larger
+// ones gather their neighbors' labels, sort them and take the longest run
+#define SMALL_DEGREE 32
+
+// Every voting kernel applies the same rule: the most frequent neighbor label wins, the
+// node keeps its current label if that label is among the most frequent, and otherwise
+// the smallest of the most frequent labels is taken.
+int voteSmallDegree(const int* neighbor_labels, int degree, int current) {
+    int table_label[SMALL_DEGREE];
+    int table_count[SMALL_DEGREE];
+    int distinct = 0;
+
+    for (int n = 0; n < degree; ++n) {
+        int label = neighbor_labels[n];
+        int t = 0;
+        while (t < distinct && table_label[t] != label) {
+            t++;
+        }
+        if (t == distinct) {
+            table_label[t] = label;
+            table_count[t] = 0;
+            distinct++;
+        }
+        table_count[t]++;
+    }
+
+    int max_count = 0;
+    int current_count = 0;
+    for (int t = 0; t < distinct; ++t) {
+        if (table_count[t] > max_count) {
+            max_count = table_count[t];
+        }
+        if (table_label[t] == current) {
+            current_count = table_count[t];
+        }
+    }
+    if (current_count == max_count) {
+        return current;
+    }
+    int max_label = -1;
+    for (int t = 0; t < distinct; ++t) {
+        if (table_count[t] == max_count && (max_label < 0 || table_label[t] < max_label)) {
+            max_label = table_label[t];
+        }
+    }
+    return max_label;
+}
+
+// LSD radix sort of non-negative labels, one byte per pass, skipping the bytes that are
+// zero for every label up to max_label
+void radixSortLabels(int* values, int* scratch, int n, int max_label) {
+    int* src = values;
+    int* dst = scratch;
+    for (int shift = 0; shift < 32 && (max_label >> shift) > 0; shift += 8) {
+        int count[257] = {0};
+        for (int i = 0; i < n; ++i) {
+            count[((src[i] >> shift) & 0xFF) + 1]++;
+        }
+        for (int b = 0; b < 256; ++b) {
+            count[b + 1] += count[b];
+        }
+        for (int i = 0; i < n; ++i) {
+            dst[count[(src[i] >> shift) & 0xFF]++] = src[i];
+        }
+        int* t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != values) {
+        memcpy(values, src, n * sizeof(int));
+    }
+}
+
+int findModeSorted(const int* sorted, int n, int current) {
+    int max_label = sorted[0];
+    int max_count = 0;
+    int current_count = 0;
+    int run_start = 0;
+    for (int i = 0; i < n; ++i) {
+        if (i == n - 1 || sorted[i] != sorted[i + 1]) {
+            int run = i + 1 - run_start;
+            if (run > max_count) { // Strict, so the smallest label wins ties
+                max_count = run;
+                max_label = sorted[i];
+            }
+            if (sorted[i] == current) {
+                current_count = run;
+            }
+            run_start = i + 1;
+        }
+    }
+    return current_count == max_count ? current : max_label;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+// Same as findModeSorted, but run boundaries are found eight labels at a time by comparing
+// the sorted buffer with itself shifted by one
+__attribute__((target("avx2")))
+int findModeSortedAVX2(const int* sorted, int n, int current) {
+    int max_label = sorted[0];
+    int max_count = 0;
+    int current_count = 0;
+    int run_start = 0;
+    int i = 0;
+    for (; i + 8 < n; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(sorted + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(sorted + i + 1));
+        unsigned equal = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+        unsigned boundaries = ~equal & 0xFF;
+        while (boundaries) {
+            int end = i + __builtin_ctz(boundaries);
+            int run = end + 1 - run_start;
+            if (run > max_count) {
+                max_count = run;
+                max_label = sorted[end];
+            }
+            if (sorted[end] == current) {
+                current_count = run;
+            }
+            run_start = end + 1;
+            boundaries &= boundaries - 1;
+        }
+    }
+    for (; i < n; ++i) {
+        if (i == n - 1 || sorted[i] != sorted[i + 1]) {
+            int run = i + 1 - run_start;
+            if (run > max_count) {
+                max_count = run;
+                max_label = sorted[i];
+            }
+            if (sorted[i] == current) {
+                current_count = run;
+            }
+            run_start = i + 1;
+        }
+    }
+    return current_count == max_count ? current : max_label;
+}
+#endif
+
+// Picks the mode kernel for the CPU we are running on
+ModeKernel selectModeKernel(void) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return findModeSortedAVX2;
+    }
+#endif
+    return findModeSorted;
+}
+
+int voteLabel(int* neighbor_labels, int* scratch, int degree, int current, int max_label, ModeKernel findMode) {
+    if (degree == 0) {
+        return current;
+    }
+    if (degree <= SMALL_DEGREE) {
+        return voteSmallDegree(neighbor_labels, degree, current);
+    }
+    radixSortLabels(neighbor_labels, scratch, degree, max_label);
+    return findMode(neighbor_labels, degree, current);
+}
+
+int maxVertexDegree(Graph* graph) {
+    int max_degree = 0;
+    for (int i = 0; i < graph->V; ++i) {
+        int degree = vertexDegree(graph, i);
+        if (degree > max_degree) {
+            max_degree = degree;
+        }
+    }
+    return max_degree;
+}
+
+int maxVotingDegree(Graph* graph, LpaDirection direction) {
+    const Graph* in = inEdgeGraph(graph);
+    if (!graph->directed) {
+        direction = LPA_OUT_EDGES;
+    }
+    int max_degree = 0;
+    for (int i = 0; i < graph->V; ++i) {
+        int degree = 0;
+        if (direction != LPA_IN_EDGES) {
+            degree += vertexDegree(graph, i);
+        }
+        if (direction != LPA_OUT_EDGES && in) {
+            degree += vertexDegree(in, i);
+        }
+        if (degree > max_degree) {
+            max_degree = degree;
+        }
+    }
+    return max_degree;
+}
+
+// Push sweeps give way to pull sweeps once the changed nodes have more than E / this many
+// edges to push along: scanning the flags of every node is then cheaper than the pushes
+#define PULL_FRONTIER_DIVISOR 20
+
+void initLpaSweep(LpaSweep* sweep, int V) {
+    sweep->active = (unsigned char*)callocArray(V, sizeof(unsigned char), "active nodes");
+    sweep->changed = (int*)mallocArray(V, sizeof(int), "changed nodes");
+    sweep->changed_count = 0;
+    sweep->push = 0;
+}
+
+void beginLpaSweeps(LpaSweep* sweep, Graph* graph, LpaDirection direction) {
+    const Graph* in = inEdgeGraph(graph);
+    if (!graph->directed) {
+        direction = LPA_OUT_EDGES;
+    }
+    if (direction != LPA_OUT_EDGES && !in) {
+        fprintf(stderr, "Voting along in-edges needs the reverse index of the directed graph\n");
+        exit(1);
+    }
+    sweep->poll[1] = NULL;
+    sweep->notify[1] = NULL;
+    if (direction == LPA_OUT_EDGES) {
+        sweep->poll[0] = graph;
+        sweep->notify[0] = in; // Without a reverse index every sweep pulls
+    } else if (direction == LPA_IN_EDGES) {
+        sweep->poll[0] = in;
+        sweep->notify[0] = graph;
+    } else {
+        sweep->poll[0] = graph;
+        sweep->poll[1] = in;
+        sweep->notify[0] = in;
+        sweep->notify[1] = graph;
+    }
+    sweep->changed_count = 0;
+    sweep->push = 0;
+    sweep->pull_threshold = graph->E / PULL_FRONTIER_DIVISOR;
+}
+
+void freeLpaSweep(LpaSweep* sweep) {
+    free(sweep->active);
+    free(sweep->changed);
+    sweep->active = NULL;
+    sweep->changed = NULL;
+}
+
+// Flags every node that polls v for relabelling
+void flagPollers(LpaSweep* sweep, int v) {
+    for (int p = 0; p < 2 && sweep->notify[p]; ++p) {
+        NeighborIterator it;
+        int dest;
+        for (neighborIteratorInit(sweep->notify[p], v, &it); neighborIteratorNext(&it, &dest);) {
+            sweep->active[dest] = 1;
+        }
+    }
+}
+
+int relabelSweep(Graph* graph, int* labels, const int* node_order, int* neighbor_labels, int* scratch,
+                 ModeKernel findMode, LpaSweep* sweep) {
+    int V = graph->V;
+    int push = sweep->push;
+    if (!push) {
+        memset(sweep->active, 0, V);
+    }
+    sweep->changed_count = 0;
+    for (int k = 0; k < V; ++k) {
+        int i = node_order[k];
+        if (push) {
+            if (!sweep->active[i]) {
+                continue;
+            }
+            sweep->active[i] = 0;
+        }
+
+        int degree = 0;
+        for (int p = 0; p < 2 && sweep->poll[p]; ++p) {
+            NeighborIterator it;
+            int dest;
+            for (neighborIteratorInit(sweep->poll[p], i, &it); neighborIteratorNext(&it, &dest);) {
+                neighbor_labels[degree++] = labels[dest];
+            }
+        }
+
+        int max_label = voteLabel(neighbor_labels, scratch, degree, labels[i], V - 1, findMode);
+        if (labels[i] != max_label) {
+            labels[i] = max_label;
+            sweep->changed[sweep->changed_count++] = i;
+            if (push) {
+                flagPollers(sweep, i); // Pollers later in node_order see it in this sweep
+            }
+        }
+    }
+
+    // Choose the next mode from the size of the frontier
+    if (sweep->notify[0]) {
+        long long frontier_edges = sweep->changed_count;
+        for (int c = 0; c < sweep->changed_count && frontier_edges <= sweep->pull_threshold; ++c) {
+            for (int p = 0; p < 2 && sweep->notify[p]; ++p) {
+                frontier_edges += vertexDegree(sweep->notify[p], sweep->changed[c]);
+            }
+        }
+        int next_push = frontier_edges <= sweep->pull_threshold;
+        if (next_push && !push) {
+            for (int c = 0; c < sweep->changed_count; ++c) {
+                flagPollers(sweep, sweep->changed[c]);
+            }
+        }
+        sweep->push = next_push;
+    }
+    return sweep->changed_count > 0;
+}
+
+// Runs label propagation to convergence from the labels already in place and returns
+// the number of iterations, shuffling with the caller's generator so that concurrent
+// runs never share RNG state
+int propagateLabels(Graph* graph, int* labels, unsigned int* rng) {
+    int V = graph->V;
+    int max_degree = maxVertexDegree(graph);
+    int* node_order = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    int* neighbor_labels = (int*)malloc((max_degree + 1) * sizeof(int));
+    int* scratch = (int*)malloc((max_degree + 1) * sizeof(int));
+    if (!node_order || !neighbor_labels || !scratch) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    ModeKernel findMode = selectModeKernel();
+    LpaSweep sweep;
+    initLpaSweep(&sweep, V);
+    beginLpaSweeps(&sweep, graph, LPA_OUT_EDGES);
+
+    for (int i = 0; i < V; ++i) {
+        node_order[i] = i;
+    }
+
+    int loop_count = 0;
+    int changed = 1;
+    while (changed && loop_count < MAX_ITER) {
+        loop_count++;
+        shuffleWithState(node_order, V, rng);
+        changed = relabelSweep(graph, labels, node_order, neighbor_labels, scratch, findMode, &sweep);
+    }
+
+    freeLpaSweep(&sweep);
+    free(neighbor_labels);
+    free(scratch);
+    free(node_order);
+    return loop_count;
+}
+
+#define LPA_CHECKPOINT_MAGIC "LPACKPT2"
+
+// Layout: magic, V, E, seed, direction, iterations done, converged flag, rand() draws
+// since srand(seed), labels[V], node_order[V]. rand() is replayed on resume, so a
+// checkpoint resumes bit-identically with the same C library it was written with.
+void saveLpaCheckpoint(const char* path, Graph* graph, unsigned int seed, int direction, int loop_count,
+                       int converged, long long draws, const int* labels, const int* node_order) {
+    CheckpointWriter writer;
+    if (!beginCheckpoint(&writer, path, LPA_CHECKPOINT_MAGIC)) {
+        return;
+    }
+    writeCheckpoint(&writer, &graph->V, sizeof(int), 1);
+    writeCheckpoint(&writer, &graph->E, sizeof(long long), 1);
+    writeCheckpoint(&writer, &seed, sizeof(unsigned int), 1);
+    writeCheckpoint(&writer, &direction, sizeof(int), 1);
+    writeCheckpoint(&writer, &loop_count, sizeof(int), 1);
+    writeCheckpoint(&writer, &converged, sizeof(int), 1);
+    writeCheckpoint(&writer, &draws, sizeof(long long), 1);
+    writeCheckpoint(&writer, labels, sizeof(int), graph->V);
+    writeCheckpoint(&writer, node_order, sizeof(int), graph->V);
+    commitCheckpoint(&writer);
+}
+
+// Returns 1 and fills the run state if path holds a valid checkpoint of this graph, seed and
+// direction
+int loadLpaCheckpoint(const char* path, Graph* graph, unsigned int seed, int direction, int* loop_count,
+                      int* converged, long long* draws, int* labels, int* node_order) {
+    FILE* file = openCheckpoint(path, LPA_CHECKPOINT_MAGIC);
+    if (!file) {
+        return 0;
+    }
+    int V;
+    long long E;
+    unsigned int saved_seed;
+    int saved_direction;
+    int ok = readCheckpoint(file, &V, sizeof(int), 1) && readCheckpoint(file, &E, sizeof(long long), 1) &&
+             readCheckpoint(file, &saved_seed, sizeof(unsigned int), 1) &&
+             readCheckpoint(file, &saved_direction, sizeof(int), 1);
+    if (!ok || V != graph->V || E != graph->E || saved_seed != seed || saved_direction != direction) {
+        fprintf(stderr, "Checkpoint %s belongs to another graph, seed or direction; starting over\n", path);
+        fclose(file);
+        return 0;
+    }
+    int saved_loop_count;
+    int saved_converged;
+    long long saved_draws;
+    ok = readCheckpoint(file, &saved_loop_count, sizeof(int), 1) &&
+         readCheckpoint(file, &saved_converged, sizeof(int), 1) &&
+         readCheckpoint(file, &saved_draws, sizeof(long long), 1) && readCheckpoint(file, labels, sizeof(int), V) &&
+         readCheckpoint(file, node_order, sizeof(int), V);
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Checkpoint %s is truncated; starting over\n", path);
+        return 0;
+    }
+
+    // node_order and labels index the graph arrays, and draws is replayed one rand() at a
+    // time, so a corrupt state is rejected here rather than read out of bounds later.
+    // shuffle draws V - 1 times per iteration, which pins draws to loop_count.
+    ok = saved_loop_count >= 0 && saved_loop_count <= MAX_ITER && (saved_converged == 0 || saved_converged == 1) &&
+         saved_draws == (long long)saved_loop_count * (V > 1 ? V - 1 : 0);
+    unsigned char* seen = (unsigned char*)callocArray(V > 0 ? V : 1, sizeof(unsigned char), "checkpoint check");
+    for (int i = 0; ok && i < V; ++i) {
+        ok = labels[i] >= 0 && labels[i] < V && node_order[i] >= 0 && node_order[i] < V && !seen[node_order[i]];
+        if (ok) {
+            seen[node_order[i]] = 1;
+        }
+    }
+    free(seen);
+    if (!ok) {
+        fprintf(stderr, "Checkpoint %s holds an invalid run state; starting over\n", path);
+        return 0;
+    }
+    *loop_count = saved_loop_count;
+    *converged = saved_converged;
+    *draws = saved_draws;
+    return 1;
+}
+
+void labelPropagation(Graph* graph, int* labels) {
+    labelPropagationCheckpointed(graph, labels, LPA_OUT_EDGES, NULL, 0);
+}
+
+void labelPropagationCheckpointed(Graph* graph, int* labels, LpaDirection direction, const char* checkpoint_path,
+                                  int checkpoint_interval) {
+    int V = graph->V;
+    unsigned int seed = 3000; // Fix the random seed for consistent results
+    int max_degree = maxVotingDegree(graph, direction);
+    int* node_order = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    int* neighbor_labels = (int*)malloc((max_degree + 1) * sizeof(int));
+    int* scratch = (int*)malloc((max_degree + 1) * sizeof(int));
+    if (!node_order || !neighbor_labels || !scratch) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    ModeKernel findMode = selectModeKernel();
+    LpaSweep sweep;
+    initLpaSweep(&sweep, V);
+    beginLpaSweeps(&sweep, graph, direction); // Also after a resume: a pull sweep is always exact
+    if (checkpoint_interval < 1) {
+        checkpoint_interval = 1;
+    }
+
+    int loop_count = 0;
+    int converged = 0;
+    long long draws = 0;
+    if (checkpoint_path && loadLpaCheckpoint(checkpoint_path, graph, seed, direction, &loop_count, &converged, &draws,
+                                             labels, node_order)) {
+        printf("Resumed from checkpoint %s after %d iterations.\n", checkpoint_path, loop_count);
+    } else {
+        // Initialize labels and node order
+        for (int i = 0; i < V; ++i) {
+            node_order[i] = i;
+            labels[i] = i; // Initialize each node with its own label
+        }
+        printf("Initialized nodes with their own labels successfully.\n");
+    }
+
+    srand(seed);
+    for (long long d = 0; d < draws; ++d) {
+        rand(); // Replay the draws made before the checkpoint
+    }
+
+    while (!converged && loop_count < MAX_ITER) {
+        loop_count++;
+        //printf("Loop count: %d\n", loop_count);
+
+        shuffle(node_order, V);
+        draws += V > 1 ? V - 1 : 0; // shuffle draws once per position but the last
+        converged = !relabelSweep(graph, labels, node_order, neighbor_labels, scratch, findMode, &sweep);
+
+        if (checkpoint_path && (converged || loop_count >= MAX_ITER || loop_count % checkpoint_interval == 0)) {
+            saveLpaCheckpoint(checkpoint_path, graph, seed, direction, loop_count, converged, draws, labels,
+                              node_order);
+        }
+    }
+    printf("Max iterations reached or no changes made. Terminating.\n");
+
+    freeLpaSweep(&sweep);
+    free(neighbor_labels);
+    free(scratch);
+    free(node_order);
+}
+
+// Relabels every node of a loaded partition in node_order; returns 1 if any label changed
+int relabelPartition(PartitionBuffer* buffer, int* labels, int* node_order, int* neighbor_labels, int* scratch,
+                     int V, ModeKernel findMode) {
+    int changed = 0;
+    for (int k = buffer->first_vertex; k < buffer->last_vertex; ++k) {
+        int i = node_order[k];
+        int local = i - buffer->first_vertex;
+        int degree = 0;
+        for (long long e = buffer->offsets[local]; e < buffer->offsets[local + 1]; ++e) {
+            neighbor_labels[degree++] = labels[buffer->neighbors[e]];
+        }
+
+        int max_label = voteLabel(neighbor_labels, scratch, degree, labels[i], V - 1, findMode);
+        if (labels[i] != max_label) {
+            labels[i] = max_label;
+            changed = 1;
+        }
+    }
+    return changed;
+}
+
+void labelPropagationExternal(ExternalGraph* graph, int* labels) {
+    int V = graph->V;
+    int partition_count = graph->partition_count;
+    int* node_order = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    int* neighbor_labels = (int*)malloc((graph->max_degree + 1) * sizeof(int));
+    int* scratch = (int*)malloc((graph->max_degree + 1) * sizeof(int));
+    if (!node_order || !neighbor_labels || !scratch) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    ModeKernel findMode = selectModeKernel();
+
+    for (int i = 0; i < V; ++i) {
+        node_order[i] = i;
+        labels[i] = i;
+    }
+    printf("Initialized nodes with their own labels successfully.\n");
+    if (partition_count == 0) {
+        free(node_order);
+        free(neighbor_labels);
+        free(scratch);
+        return;
+    }
+
+    // A single partition stays resident; otherwise two buffers alternate
+    PartitionBuffer buffers[2];
+    initPartitionBuffer(graph, &buffers[0]);
+    if (partition_count > 1) {
+        initPartitionBuffer(graph, &buffers[1]);
+    }
+    int current = 0;
+    loadPartition(graph, 0, &buffers[0]);
+
+    srand(3000); // Fix the random seed for consistent results
+
+    int loop_count = 0;
+    while (1) {
+        loop_count++;
+        int changed = 0;
+
+        for (int p = 0; p < partition_count; ++p) {
+            PartitionBuffer* active = &buffers[current];
+            PartitionBuffer* next = &buffers[1 - current];
+            int prefetch = partition_count > 1 ? (p + 1) % partition_count : -1;
+            shuffle(node_order + active->first_vertex, active->last_vertex - active->first_vertex);
+
+            #pragma omp parallel sections num_threads(2) reduction(|:changed)
+            {
+                #pragma omp section
+                {
+                    if (prefetch >= 0) {
+                        loadPartition(graph, prefetch, next);
+                    }
+                }
+                #pragma omp section
+                {
+                    changed |= relabelPartition(active, labels, node_order, neighbor_labels, scratch, V, findMode);
+                }
+            }
+
+            if (partition_count > 1) {
+                current = 1 - current;
+            }
+        }
+
+        if (!changed || loop_count >= MAX_ITER) {
+            printf("Max iterations reached or no changes made. Terminating.\n");
+            break;
+        }
+    }
+
+    freePartitionBuffer(&buffers[0]);
+    if (partition_count > 1) {
+        freePartitionBuffer(&buffers[1]);
+    }
+    free(neighbor_labels);
+    free(scratch);
+    free(node_order);
+}
+
+// Grows a voting buffer so it can hold the labels of a node with the given degree
+void ensureVoteCapacity(int** neighbor_labels, int** scratch, int* capacity, int degree) {
+    if (degree <= *capacity) {
+        return;
+    }
+    while (*capacity < degree) {
+        *capacity = *capacity > 0 ? 2 * *capacity : 64;
+    }
+    *neighbor_labels = (int*)realloc(*neighbor_labels, *capacity * sizeof(int));
+    *scratch = (int*)realloc(*scratch, *capacity * sizeof(int));
+    if (!*neighbor_labels || !*scratch) {
+        fprintf(stderr, "Memory allocation failed for voting buffers\n");
+        exit(1);
+    }
+}
+
+int updateLabelsIncremental(Graph* graph, int* labels, const EdgeUpdate* updates, int update_count) {
+    int V = graph->V;
+    int* queue = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    unsigned char* queued = (unsigned char*)calloc(V > 0 ? V : 1, sizeof(unsigned char));
+    int* neighbor_labels = NULL;
+    int* scratch = NULL;
+    int capacity = 0;
+    if (!queue || !queued) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    ModeKernel findMode = selectModeKernel();
+    // Nodes vote with their successors, so a label change matters to the predecessors
+    const Graph* pollers = inEdgeGraph(graph) ? inEdgeGraph(graph) : graph;
+
+    // Circular FIFO of nodes to re-evaluate; queued[] keeps every node in it at most once
+    int head = 0;
+    int size = 0;
+    #define ENQUEUE(v) \
+        do { \
+            if (!queued[(v)]) { \
+                queued[(v)] = 1; \
+                queue[(head + size++) % V] = (v); \
+            } \
+        } while (0)
+
+    for (int u = 0; u < update_count; ++u) {
+        int src = updates[u].src;
+        int dest = updates[u].dest;
+        if (updates[u].insert) {
+            addEdge(graph, src, dest);
+        } else if (!removeEdge(graph, src, dest)) {
+            fprintf(stderr, "Skipping deletion of missing edge %d -> %d\n", src, dest);
+            continue;
+        }
+        ENQUEUE(src);
+        ENQUEUE(dest);
+    }
+
+    // Asynchronous LPA restricted to the affected region. The evaluation budget matches
+    // the MAX_ITER sweeps a full run may make, so oscillating labels still terminate.
+    long long budget = (long long)MAX_ITER * V;
+    int changes = 0;
+    while (size > 0 && budget-- > 0) {
+        int i = queue[head];
+        head = (head + 1) % V;
+        size--;
+        queued[i] = 0;
+
+        NeighborIterator it;
+        int dest;
+        int degree = vertexDegree(graph, i);
+        ensureVoteCapacity(&neighbor_labels, &scratch, &capacity, degree);
+
+        degree = 0;
+        for (neighborIteratorInit(graph, i, &it); neighborIteratorNext(&it, &dest);) {
+            neighbor_labels[degree++] = labels[dest];
+        }
+
+        int max_label = voteLabel(neighbor_labels, scratch, degree, labels[i], V - 1, findMode);
+        if (labels[i] != max_label) {
+            labels[i] = max_label;
+            changes++;
+            // Only nodes that see i can be affected. Without an in-edge index a directed
+            // graph can only reach i's successors here.
+            for (neighborIteratorInit(pollers, i, &it); neighborIteratorNext(&it, &dest);) {
+                ENQUEUE(dest);
+            }
+        }
+    }
+    #undef ENQUEUE
+
+    free(neighbor_labels);
+    free(scratch);
+    free(queue);
+    free(queued);
+    return changes;
+}
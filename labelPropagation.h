@@ -0,0 +1,82 @@
+#ifndef LABEL_PROPAGATION_H
+#define LABEL_PROPAGATION_H
+
+#include "graph.h"
+#include "externalGraph.h"
+
+#define MAX_ITER 1000
+
+// Finds the most frequent label in a sorted buffer (see voteLabel for the tie rule)
+typedef int (*ModeKernel)(const int* sorted, int n, int current);
+
+// Which neighbors a node polls for labels on a directed graph: its successors, its
+// predecessors or both. Directions other than LPA_OUT_EDGES need buildReverseIndex first.
+// Undirected graphs treat every direction as LPA_OUT_EDGES.
+typedef enum {
+    LPA_OUT_EDGES,
+    LPA_IN_EDGES,
+    LPA_BOTH_EDGES
+} LpaDirection;
+
+// Push/pull sweep state. A pull sweep relabels every node. A push sweep relabels only the
+// nodes flagged in active, and a label change flags every node that polls the changed one.
+// Both produce the labels of a full sweep, since a node whose polled labels are unchanged
+// would vote for its own label again. After each sweep the next mode is chosen from the
+// number of edges leaving the nodes that changed: pull when they exceed pull_threshold.
+typedef struct {
+    const Graph* poll[2];    // Adjacency each node reads labels through (second may be NULL)
+    const Graph* notify[2];  // Adjacency reaching the nodes that poll a node; NULL: pull only
+    unsigned char* active;
+    int* changed;
+    int changed_count;
+    int push;                // Mode of the next sweep
+    long long pull_threshold;
+} LpaSweep;
+
+void initializeLabels(int* labels, int V);
+void shuffle(int* array, int n);
+unsigned int nextRandom(unsigned int* state);
+void seedRandom(unsigned int* state, unsigned int seed);
+void shuffleWithState(int* array, int n, unsigned int* state);
+ModeKernel selectModeKernel(void);
+int voteLabel(int* neighbor_labels, int* scratch, int degree, int current, int max_label, ModeKernel findMode);
+int maxVertexDegree(Graph* graph);
+// Largest number of labels one node polls in the given direction
+int maxVotingDegree(Graph* graph, LpaDirection direction);
+
+void initLpaSweep(LpaSweep* sweep, int V);
+// Prepares sweep for a run in the given direction; the first sweep pulls
+void beginLpaSweeps(LpaSweep* sweep, Graph* graph, LpaDirection direction);
+void freeLpaSweep(LpaSweep* sweep);
+// Relabels the nodes in node_order once, all of them (pull) or the flagged ones (push);
+// neighbor_labels and scratch hold maxVotingDegree + 1 labels. Returns 1 if any label
+// changed.
+int relabelSweep(Graph* graph, int* labels, const int* node_order, int* neighbor_labels, int* scratch,
+                 ModeKernel findMode, LpaSweep* sweep);
+
+int propagateLabels(Graph* graph, int* labels, unsigned int* rng);
+void labelPropagation(Graph* graph, int* labels);
+
+// labelPropagation in the given direction that writes its labels, node order, iteration
+// count and RNG position to checkpoint_path every checkpoint_interval iterations and after
+// the last one. When checkpoint_path already holds a checkpoint of the same graph and
+// direction, the run resumes from it and finishes with exactly the labels an uninterrupted
+// run would produce.
+void labelPropagationCheckpointed(Graph* graph, int* labels, LpaDirection direction, const char* checkpoint_path,
+                                  int checkpoint_interval);
+
+// Label propagation over a partitioned graph on disk. Only the labels, the node order and
+// two partition buffers are resident; the next partition is read by a second thread while
+// the current one is relabelled. Nodes are visited partition by partition, each in
+// shuffled order, so labels can differ from labelPropagation on the same graph.
+void labelPropagationExternal(ExternalGraph* graph, int* labels);
+
+// Applies a batch of edge insertions and deletions to the graph and updates labels in
+// place, starting from the endpoints of the changed edges and spreading only to the nodes
+// that poll a node whose label changes. On a directed graph those are its predecessors,
+// which takes the reverse index; without one the update falls back to the successors.
+// Update endpoints must lie in [0, V), as readEdgeUpdates guarantees. Returns the number
+// of label changes made.
+int updateLabelsIncremental(Graph* graph, int* labels, const EdgeUpdate* updates, int update_count);
+
+#endif // LABEL_PROPAGATION_H
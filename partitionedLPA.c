@@ -0,0 +1,427 @@
+// partitionedLPA.c
+#ifndef _WIN32
+#define _GNU_SOURCE // pthread barriers and MAP_ANONYMOUS are hidden under a strict -std=c11
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "partitionedLPA.h"
+#include "labelPropagation.h"
+
+#ifdef _WIN32
+
+int labelPropagationPartitioned(Graph* graph, int* labels, int worker_count) {
+    (void)worker_count;
+    printf("Partitioned LPA needs POSIX processes; running single-process LPA instead.\n");
+    labelPropagation(graph, labels);
+    return 0;
+}
+
+#else
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Exit status of a worker that could not run; the others are stopped when one fails
+#define WORKER_FAILED 3
+
+typedef struct {
+    int vertex;
+    int label;
+} LabelUpdate;
+
+// Layout of the shared mapping: this header, then the per-worker outboxes, then the
+// final labels
+typedef struct {
+    pthread_barrier_t barrier;
+    int worker_count;
+    int V;
+} SharedHeader;
+
+typedef struct {
+    SharedHeader* header;
+    int* worker_changed;     // One flag per worker for the current iteration
+    int* outbox_count;       // Number of updates each worker published this iteration
+    long long* outbox_start; // First slot of each worker's outbox
+    LabelUpdate* outboxes;
+    int* final_labels;
+} SharedRegion;
+
+// Splits [0, V) into worker_count ranges with roughly equal degree + 1 sums
+void partitionVertices(Graph* graph, int worker_count, int* first_vertex) {
+    int V = graph->V;
+    long long total = 0;
+    int* weight = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    if (!weight) {
+        fprintf(stderr, "Memory allocation failed for partitioning\n");
+        exit(1);
+    }
+    for (int v = 0; v < V; ++v) {
+        weight[v] = vertexDegree(graph, v) + 1;
+        total += weight[v];
+    }
+
+    int w = 0;
+    long long sum = 0;
+    first_vertex[0] = 0;
+    for (int v = 0; v < V && w + 1 < worker_count; ++v) {
+        sum += weight[v];
+        if (sum >= total * (w + 1) / worker_count) {
+            first_vertex[++w] = v + 1;
+        }
+    }
+    while (w + 1 < worker_count) {
+        first_vertex[++w] = V;
+    }
+    first_vertex[worker_count] = V;
+    free(weight);
+}
+
+// Returns the position of vertex in the sorted ghost list, or -1
+int findGhost(const int* ghosts, int ghost_count, int vertex) {
+    int low = 0;
+    int high = ghost_count - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        if (ghosts[mid] < vertex) {
+            low = mid + 1;
+        } else if (ghosts[mid] > vertex) {
+            high = mid - 1;
+        } else {
+            return mid;
+        }
+    }
+    return -1;
+}
+
+int compareVertices(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Runs one worker to convergence and returns its exit status. The worker only keeps its
+// own vertices [first, last) and their ghosts, the vertices of other partitions they poll:
+// it copies its slice of the adjacency with local ids (own vertex i is i - first, ghost j
+// is count + j) and holds labels for those alone.
+int runWorker(Graph* graph, SharedRegion* shared, int worker, int first, int last,
+              const unsigned char* is_boundary) {
+    int V = graph->V;
+    int worker_count = shared->header->worker_count;
+    int count = last - first;
+    long long edge_count = 0;
+    long long cut_count = 0;
+    int max_degree = 0;
+    for (int i = first; i < last; ++i) {
+        NeighborIterator it;
+        int dest;
+        int degree = 0;
+        for (neighborIteratorInit(graph, i, &it); neighborIteratorNext(&it, &dest);) {
+            degree++;
+            cut_count += dest < first || dest >= last;
+        }
+        edge_count += degree;
+        if (degree > max_degree) {
+            max_degree = degree;
+        }
+    }
+
+    int* ghosts = (int*)malloc((cut_count > 0 ? cut_count : 1) * sizeof(int));
+    long long* offsets = (long long*)malloc((count + 1) * sizeof(long long));
+    int* adjacency = (int*)malloc((edge_count > 0 ? edge_count : 1) * sizeof(int));
+    int* node_order = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    int* neighbor_labels = (int*)malloc((max_degree + 1) * sizeof(int));
+    int* scratch = (int*)malloc((max_degree + 1) * sizeof(int));
+    int* labels = NULL;
+    int ghost_count = 0;
+    if (ghosts && offsets && adjacency) {
+        for (int i = first; i < last; ++i) {
+            NeighborIterator it;
+            int dest;
+            for (neighborIteratorInit(graph, i, &it); neighborIteratorNext(&it, &dest);) {
+                if (dest < first || dest >= last) {
+                    ghosts[ghost_count++] = dest;
+                }
+            }
+        }
+        qsort(ghosts, ghost_count, sizeof(int), compareVertices);
+        int unique = 0;
+        for (int g = 0; g < ghost_count; ++g) {
+            if (unique == 0 || ghosts[g] != ghosts[unique - 1]) {
+                ghosts[unique++] = ghosts[g];
+            }
+        }
+        ghost_count = unique;
+        labels = (int*)malloc((count + ghost_count > 0 ? count + ghost_count : 1) * sizeof(int));
+    }
+    if (!ghosts || !offsets || !adjacency || !node_order || !neighbor_labels || !scratch || !labels) {
+        fprintf(stderr, "Memory allocation failed in worker %d\n", worker);
+        free(ghosts);
+        free(offsets);
+        free(adjacency);
+        free(node_order);
+        free(neighbor_labels);
+        free(scratch);
+        free(labels);
+        return WORKER_FAILED;
+    }
+
+    long long e = 0;
+    for (int i = first; i < last; ++i) {
+        offsets[i - first] = e;
+        NeighborIterator it;
+        int dest;
+        for (neighborIteratorInit(graph, i, &it); neighborIteratorNext(&it, &dest);) {
+            adjacency[e++] = dest >= first && dest < last ? dest - first
+                                                          : count + findGhost(ghosts, ghost_count, dest);
+        }
+    }
+    offsets[count] = e;
+    for (int i = 0; i < count; ++i) {
+        labels[i] = first + i; // Every vertex starts with its own id as label
+        node_order[i] = i;
+    }
+    for (int g = 0; g < ghost_count; ++g) {
+        labels[count + g] = ghosts[g];
+    }
+    ModeKernel findMode = selectModeKernel();
+    LabelUpdate* outbox = shared->outboxes + shared->outbox_start[worker];
+    srand(3000 + worker); // Worker 0 draws the same order as labelPropagation
+
+    int loop_count = 0;
+    while (1) {
+        loop_count++;
+        int changed = 0;
+        int published = 0;
+
+        shuffle(node_order, count);
+        for (int k = 0; k < count; ++k) {
+            int i = node_order[k];
+            int degree = 0;
+            for (long long n = offsets[i]; n < offsets[i + 1]; ++n) {
+                neighbor_labels[degree++] = labels[adjacency[n]];
+            }
+
+            int max_label = voteLabel(neighbor_labels, scratch, degree, labels[i], V - 1, findMode);
+            if (labels[i] != max_label) {
+                labels[i] = max_label;
+                changed = 1;
+                if (is_boundary[first + i]) {
+                    outbox[published].vertex = first + i;
+                    outbox[published].label = max_label;
+                    published++;
+                }
+            }
+        }
+        shared->outbox_count[worker] = published;
+        shared->worker_changed[worker] = changed;
+        pthread_barrier_wait(&shared->header->barrier);
+
+        // Pull the changed boundary labels of the ghosts
+        int any_changed = 0;
+        for (int w = 0; w < worker_count; ++w) {
+            any_changed |= shared->worker_changed[w];
+            if (w == worker) {
+                continue;
+            }
+            LabelUpdate* inbox = shared->outboxes + shared->outbox_start[w];
+            for (int u = 0; u < shared->outbox_count[w]; ++u) {
+                int g = findGhost(ghosts, ghost_count, inbox[u].vertex);
+                if (g >= 0) {
+                    labels[count + g] = inbox[u].label;
+                }
+            }
+        }
+        // Nobody may overwrite an outbox until every worker has read it
+        pthread_barrier_wait(&shared->header->barrier);
+
+        if (!any_changed || loop_count >= MAX_ITER) {
+            break;
+        }
+    }
+
+    memcpy(shared->final_labels + first, labels, count * sizeof(int));
+    free(ghosts);
+    free(offsets);
+    free(adjacency);
+    free(node_order);
+    free(neighbor_labels);
+    free(scratch);
+    free(labels);
+    return 0;
+}
+
+int labelPropagationPartitioned(Graph* graph, int* labels, int worker_count) {
+    int V = graph->V;
+    if (worker_count < 1) {
+        worker_count = 1;
+    }
+    printf("Running partitioned LPA with %d worker processes...\n", worker_count);
+
+    int* first_vertex = (int*)malloc((worker_count + 1) * sizeof(int));
+    int* owner = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    unsigned char* is_boundary = (unsigned char*)calloc(V > 0 ? V : 1, sizeof(unsigned char));
+    long long* boundary_count = (long long*)calloc(worker_count, sizeof(long long));
+    if (!first_vertex || !owner || !is_boundary || !boundary_count) {
+        fprintf(stderr, "Memory allocation failed for partitioned LPA\n");
+        exit(1);
+    }
+    partitionVertices(graph, worker_count, first_vertex);
+    for (int w = 0; w < worker_count; ++w) {
+        for (int v = first_vertex[w]; v < first_vertex[w + 1]; ++v) {
+            owner[v] = w;
+        }
+    }
+
+    // A vertex is on the boundary if a vertex of another partition votes with its label
+    for (int u = 0; u < V; ++u) {
+        NeighborIterator it;
+        int dest;
+        for (neighborIteratorInit(graph, u, &it); neighborIteratorNext(&it, &dest);) {
+            if (owner[dest] != owner[u]) {
+                is_boundary[dest] = 1;
+            }
+        }
+    }
+    for (int v = 0; v < V; ++v) {
+        boundary_count[owner[v]] += is_boundary[v];
+    }
+
+    long long total_slots = 0;
+    for (int w = 0; w < worker_count; ++w) {
+        total_slots += boundary_count[w];
+    }
+    size_t size = sizeof(SharedHeader)
+                + 2 * worker_count * sizeof(int)
+                + worker_count * sizeof(long long)
+                + total_slots * sizeof(LabelUpdate)
+                + (size_t)V * sizeof(int);
+    void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Shared memory allocation failed for partitioned LPA\n");
+        exit(1);
+    }
+
+    SharedRegion shared;
+    char* cursor = (char*)mapping;
+    shared.header = (SharedHeader*)cursor;
+    cursor += sizeof(SharedHeader);
+    shared.outbox_start = (long long*)cursor;
+    cursor += worker_count * sizeof(long long);
+    shared.outboxes = (LabelUpdate*)cursor;
+    cursor += total_slots * sizeof(LabelUpdate);
+    shared.worker_changed = (int*)cursor;
+    cursor += worker_count * sizeof(int);
+    shared.outbox_count = (int*)cursor;
+    cursor += worker_count * sizeof(int);
+    shared.final_labels = (int*)cursor;
+
+    shared.header->worker_count = worker_count;
+    shared.header->V = V;
+    long long slot = 0;
+    for (int w = 0; w < worker_count; ++w) {
+        shared.outbox_start[w] = slot;
+        slot += boundary_count[w];
+    }
+    printf("%lld boundary vertices shared between partitions.\n", total_slots);
+
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    if (pthread_barrier_init(&shared.header->barrier, &attr, worker_count) != 0) {
+        fprintf(stderr, "Barrier initialization failed for partitioned LPA\n");
+        exit(1);
+    }
+    pthread_barrierattr_destroy(&attr);
+
+    // Workers inherit the graph copy-on-write and never modify it
+    fflush(stdout);
+    pid_t* pids = (pid_t*)malloc(worker_count * sizeof(pid_t));
+    if (!pids) {
+        fprintf(stderr, "Memory allocation failed for worker ids\n");
+        exit(1);
+    }
+    int failed = 0;
+    int running = 0;
+    for (int w = 0; w < worker_count; ++w) {
+        pids[w] = fork();
+        if (pids[w] < 0) {
+            fprintf(stderr, "Failed to start worker %d\n", w);
+            failed = 1;
+            for (int started = 0; started < w; ++started) {
+                kill(pids[started], SIGKILL);
+            }
+            for (int rest = w; rest < worker_count; ++rest) {
+                pids[rest] = 0;
+            }
+            break;
+        }
+        if (pids[w] == 0) {
+            _exit(runWorker(graph, &shared, w, first_vertex[w], first_vertex[w + 1], is_boundary));
+        }
+        running++;
+    }
+
+    // Reap workers as they finish, polling their own pids so other children of the caller
+    // are left alone. The survivors of a failed worker would wait at the barrier forever,
+    // so the first failure stops all of them.
+    struct timespec pause = { 0, 1000000 };
+    while (running > 0) {
+        int reaped = 0;
+        for (int w = 0; w < worker_count; ++w) {
+            if (pids[w] <= 0) {
+                continue;
+            }
+            int status = 0;
+            pid_t pid = waitpid(pids[w], &status, WNOHANG);
+            if (pid == 0) {
+                continue; // Still running
+            }
+            pids[w] = 0;
+            running--;
+            reaped = 1;
+            if (!failed && (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+                failed = 1;
+                if (pid < 0) {
+                    fprintf(stderr, "Lost track of partitioned LPA worker %d\n", w);
+                } else if (WIFSIGNALED(status)) {
+                    fprintf(stderr, "Partitioned LPA worker %d was killed by signal %d\n", w, WTERMSIG(status));
+                } else {
+                    fprintf(stderr, "Partitioned LPA worker %d exited with status %d\n", w, WEXITSTATUS(status));
+                }
+                for (int other = 0; other < worker_count; ++other) {
+                    if (pids[other] > 0) {
+                        kill(pids[other], SIGKILL);
+                    }
+                }
+            }
+        }
+        if (!reaped) {
+            nanosleep(&pause, NULL);
+        }
+    }
+
+    if (!failed) {
+        memcpy(labels, shared.final_labels, V * sizeof(int));
+        printf("Partitioned LPA completed.\n");
+    }
+
+    // Killed workers can leave the barrier looking busy, and destroying it would then wait
+    // for them forever; unmapping is enough
+    if (!failed) {
+        pthread_barrier_destroy(&shared.header->barrier);
+    }
+    munmap(mapping, size);
+    free(pids);
+    free(first_vertex);
+    free(owner);
+    free(is_boundary);
+    free(boundary_count);
+    return failed ? -1 : 0;
+}
+
+#endif
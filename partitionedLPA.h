@@ -0,0 +1,17 @@
+#ifndef PARTITIONED_LPA_H
+#define PARTITIONED_LPA_H
+
+#include "graph.h"
+
+// Runs label propagation with the vertex set split into worker_count contiguous,
+// edge-balanced partitions, each relabelled by its own worker process. A worker holds only
+// its partition's adjacency and the labels of its vertices and of their neighbors in other
+// partitions. After every iteration workers exchange only the new labels of boundary vertices
+// (vertices read by another partition) through a shared-memory mailbox, then meet at a
+// process-shared barrier. With one worker the result matches labelPropagation.
+// Requires POSIX fork and shared memory; elsewhere it falls back to labelPropagation.
+// Returns 0, or -1 if a worker failed, in which case the others are killed and labels is
+// left untouched.
+int labelPropagationPartitioned(Graph* graph, int* labels, int worker_count);
+
+#endif // PARTITIONED_LPA_H
@@ -1,23 +1,51 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "performanceMeasure.h"
 #include "graph.h"
 
-double calculateModularity(Graph* graph, int* community, int V, int E, int directed) {
+void initMetricsWorkspace(MetricsWorkspace* workspace, int V) {
+    workspace->V = V;
+    workspace->community_edges = (long long*)mallocArray(V, sizeof(long long), "community edges");
+    workspace->boundary_edges = (long long*)mallocArray(V, sizeof(long long), "boundary edges");
+    workspace->total_degree = (int*)mallocArray(V, sizeof(int), "degrees");
+}
+
+void freeMetricsWorkspace(MetricsWorkspace* workspace) {
+    free(workspace->community_edges);
+    free(workspace->boundary_edges);
+    free(workspace->total_degree);
+    workspace->community_edges = NULL;
+    workspace->boundary_edges = NULL;
+    workspace->total_degree = NULL;
+}
+
+double calculateModularity(Graph* graph, int* community, int V, long long E, int directed) {
+    MetricsWorkspace workspace;
+    initMetricsWorkspace(&workspace, V);
+    double modularity = modularityWithWorkspace(graph, community, V, E, directed, &workspace);
+    freeMetricsWorkspace(&workspace);
+    return modularity;
+}
+
+double modularityWithWorkspace(Graph* graph, int* community, int V, long long E, int directed,
+                               MetricsWorkspace* workspace) {
     double modularity = 0.0;
-    int* communityEdges = (int*)calloc(V, sizeof(int));  // Tracks internal edges for each community
-    int* totalDegree = (int*)calloc(V, sizeof(int));     // Tracks total degree for each community
+    long long* communityEdges = workspace->community_edges;  // Tracks internal edges for each community
+    int* totalDegree = workspace->total_degree;              // Tracks total degree for each community
+    memset(communityEdges, 0, V * sizeof(long long));
+    memset(totalDegree, 0, V * sizeof(int));
 
     // Calculate communityEdges and totalDegree
     for (int v = 0; v < V; ++v) {
-        Node* node = graph->array[v].head;
-        while (node) {
-            // If node v and node->dest are in the same community, update community edges
-            if (community[v] == community[node->dest]) {
+        NeighborIterator it;
+        int dest;
+        for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &dest);) {
+            // If node v and dest are in the same community, update community edges
+            if (community[v] >= 0 && community[v] == community[dest]) {
                 communityEdges[community[v]]++;  // Community edge count
             }
             totalDegree[v]++;  // Degree of node v (not community)
-            node = node->next;
         }
     }
     // Check if there is only one community
@@ -28,56 +56,57 @@ double calculateModularity(Graph* graph, int* community, int V, int E, int direc
         }
     }
     if (unique_communities <= 1) {
-        free(communityEdges);
-        free(totalDegree);
         return 0.0;  // Modularity is zero when there is only one community
     }
     // Calculate modularity for each community
     for (int i = 0; i < V; ++i) {
         if (totalDegree[i] > 0) {
-            double eii = (double)communityEdges[i] / (directed ? E : (2 * E)); // Proportion of edges within the community
-            double ai = (double)totalDegree[i] / (directed ? E : (2 * E)); // Proportion of total degree
+            double eii = (double)communityEdges[i] / (double)(directed ? E : (2 * E)); // Proportion of edges within the community
+            double ai = (double)totalDegree[i] / (double)(directed ? E : (2 * E)); // Proportion of total degree
             modularity += eii - ai * ai; // Modularity contribution from community i
         }
     }
-    // Clean up memory
-    free(communityEdges);
-    free(totalDegree);
 
     return modularity;
 }
 
 
 double calculateConductance(Graph* graph, int* labels, int V, int directed) {
+    MetricsWorkspace workspace;
+    initMetricsWorkspace(&workspace, V);
+    double conductance = conductanceWithWorkspace(graph, labels, V, directed, &workspace);
+    freeMetricsWorkspace(&workspace);
+    return conductance;
+}
+
+double conductanceWithWorkspace(Graph* graph, int* labels, int V, int directed, MetricsWorkspace* workspace) {
     double conductance = 0.0;
-    int* communityEdges = (int*)calloc(V, sizeof(int));  // Internal edges
-    int* boundaryEdges = (int*)calloc(V, sizeof(int));  // Boundary edges
-    int* totalDegree = (int*)calloc(V, sizeof(int));     // Node degree
-
-    if (!communityEdges || !boundaryEdges || !totalDegree) {
-        fprintf(stderr, "Memory allocation failed for conductance calculation\n");
-        free(communityEdges);
-        free(boundaryEdges);
-        free(totalDegree);
-        return 0.0;
-    }
+    long long* communityEdges = workspace->community_edges;  // Internal edges
+    long long* boundaryEdges = workspace->boundary_edges;    // Boundary edges
+    int* totalDegree = workspace->total_degree;              // Node degree
+    memset(communityEdges, 0, V * sizeof(long long));
+    memset(boundaryEdges, 0, V * sizeof(long long));
+    memset(totalDegree, 0, V * sizeof(int));
+
      for (int v = 0; v < V; ++v) {
-        Node* node = graph->array[v].head;
-        while (node) {
+        NeighborIterator it;
+        int dest;
+        for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &dest);) {
             totalDegree[v]++;  // Count degree of node v
 
-            if (labels[v] == labels[node->dest]) {
-                communityEdges[labels[v]]++;  // Internal edge
-            } else {
-                boundaryEdges[labels[v]]++;  // Boundary edge
+            // Nodes without a community (label -1, e.g. outside every CPM clique) are skipped
+            if (labels[v] >= 0) {
+                if (labels[v] == labels[dest]) {
+                    communityEdges[labels[v]]++;  // Internal edge
+                } else {
+                    boundaryEdges[labels[v]]++;  // Boundary edge
+                }
             }
 
             // For undirected graphs, count the boundary edge for the destination node as well
-            if (!directed && labels[v] != labels[node->dest]) {
-                boundaryEdges[labels[node->dest]]++;  // Add boundary edge for the destination node
+            if (!directed && labels[dest] >= 0 && labels[v] != labels[dest]) {
+                boundaryEdges[labels[dest]]++;  // Add boundary edge for the destination node
             }
-
-            node = node->next;
         }
     }
 
@@ -85,9 +114,8 @@ double calculateConductance(Graph* graph, int* labels, int V, int directed) {
     for (int i = 0; i < V; ++i) {
         if (totalDegree[i] > 0) {
             num_communities++;
-            double internal = communityEdges[i];
-            double boundary = boundaryEdges[i];
-            double degree = totalDegree[i];
+            double internal = (double)communityEdges[i];
+            double boundary = (double)boundaryEdges[i];
              if (boundary > 0) {
                 conductance += boundary / (internal + boundary);
             }
@@ -99,31 +127,27 @@ double calculateConductance(Graph* graph, int* labels, int V, int directed) {
         conductance /= num_communities;
     }
 
-    // Clean up memory
-    free(communityEdges);
-    free(boundaryEdges);
-    free(totalDegree);
-
      return conductance;
 }
 
-double calculateCoverage(Graph* graph, int* community, int V, int E, int directed) { 
-    int intraCommunityEdges = 0;
+double calculateCoverage(Graph* graph, int* community, int V, long long E, int directed) { 
+    long long intraCommunityEdges = 0;
 
     for (int v = 0; v < V; ++v) {
-        Node* node = graph->array[v].head;
-        while (node) {
-            // For directed graphs, count the edge from v to node->dest
-            // For undirected graphs, count the edge from v to node->dest only if v < node->dest
-            if (community[v] == community[node->dest]) {
-                if (directed || v < node->dest) {
+        NeighborIterator it;
+        int dest;
+        for (neighborIteratorInit(graph, v, &it); neighborIteratorNext(&it, &dest);) {
+            // For directed graphs, count the edge from v to dest
+            // For undirected graphs, count the edge from v to dest only if v < dest
+            // Nodes labelled -1 belong to no community
+            if (community[v] >= 0 && community[v] == community[dest]) {
+                if (directed || v < dest) {
                     intraCommunityEdges++;
                 }
             }
-            node = node->next;
         }
     }
 
-    double coverage = (double)intraCommunityEdges / (directed ? E : (2 * E));
+    double coverage = (double)intraCommunityEdges / (double)(directed ? E : (2 * E));
     return coverage;
 }
@@ -3,8 +3,24 @@
 
 #include "graph.h"
 
-double calculateModularity(Graph* graph, int* community, int V, int E, int directed);
+// Scratch arrays for evaluating the metrics repeatedly on graphs of V vertices; the
+// WithWorkspace variants reuse them instead of allocating on every call
+typedef struct {
+    int V;
+    long long* community_edges;
+    long long* boundary_edges;
+    int* total_degree;
+} MetricsWorkspace;
+
+void initMetricsWorkspace(MetricsWorkspace* workspace, int V);
+void freeMetricsWorkspace(MetricsWorkspace* workspace);
+
+double calculateModularity(Graph* graph, int* community, int V, long long E, int directed);
 double calculateConductance(Graph* graph, int* labels, int V, int directed);
-double calculateCoverage(Graph* graph, int* community, int V, int E, int directed);
+double calculateCoverage(Graph* graph, int* community, int V, long long E, int directed);
+
+double modularityWithWorkspace(Graph* graph, int* community, int V, long long E, int directed,
+                               MetricsWorkspace* workspace);
+double conductanceWithWorkspace(Graph* graph, int* labels, int V, int directed, MetricsWorkspace* workspace);
 
 #endif // PERFORMANCE_MEASURE_H
\ No newline at end of file